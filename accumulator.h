@@ -0,0 +1,63 @@
+#ifndef ACCUMULATOR_H
+#define ACCUMULATOR_H
+
+#include <cmath>
+
+// Políticas de acumulación para las sumas de StatsPartial. Todas exponen
+// add(), merge() y value(); vectorizable indica si los núcleos SIMD pueden
+// usarse con la política y compensated si sus carriles llevan corrección.
+
+// Suma directa en double
+struct PlainAccumulator {
+    static const bool vectorizable = true;
+    static const bool compensated = false;
+    static const char* name() { return "plain"; }
+
+    double total = 0.0;
+
+    void add(double x) { total += x; }
+    void merge(const PlainAccumulator& other) { total += other.total; }
+    double value() const { return total; }
+};
+
+// Suma compensada de Kahan-Babuška-Neumaier: el error de redondeo de cada
+// suma se guarda en comp y se reincorpora al final
+struct KahanAccumulator {
+    static const bool vectorizable = true;
+    static const bool compensated = true;
+    static const char* name() { return "kahan"; }
+
+    double total = 0.0;
+    double comp = 0.0;
+
+    void add(double x) {
+        double t = total + x;
+        if (std::abs(total) >= std::abs(x)) {
+            comp += (total - t) + x;
+        } else {
+            comp += (x - t) + total;
+        }
+        total = t;
+    }
+    void merge(const KahanAccumulator& other) {
+        add(other.total);
+        add(other.comp);
+    }
+    double value() const { return total + comp; }
+};
+
+// Suma en long double (80 bits en x86); no hay carriles SIMD de ese tipo,
+// así que siempre usa el núcleo escalar
+struct LongDoubleAccumulator {
+    static const bool vectorizable = false;
+    static const bool compensated = false;
+    static const char* name() { return "longdouble"; }
+
+    long double total = 0.0L;
+
+    void add(double x) { total += x; }
+    void merge(const LongDoubleAccumulator& other) { total += other.total; }
+    double value() const { return static_cast<double>(total); }
+};
+
+#endif // ACCUMULATOR_H
@@ -0,0 +1,207 @@
+#ifndef ADAPTIVE_H
+#define ADAPTIVE_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "chunking.h"
+#include "dataset.h"
+#include "stats_kernel.h"
+#include "stats_partial.h"
+
+// Estrategia adaptativa: un modelo de coste sencillo, calibrado una vez por
+// máquina, decide en cada llamada si compensa repartir el trabajo y cómo.
+// Con c ns por elemento y p hilos, el cálculo cuesta n * c / p más el reparto:
+//   - DivideConquer: fork_ns por nivel del árbol, con p = 2^niveles
+//   - ThreadPool: dispatch_ns de latencia más task_ns por tarea adicional
+// y el secuencial cuesta n * c sin reparto. La calibración se guarda en un
+// fichero de perfil para que las siguientes ejecuciones la reutilicen.
+
+const char* const DEFAULT_TUNING_PROFILE = "tuning.profile";
+
+enum PlanKind {
+    PLAN_SEQUENTIAL,
+    PLAN_DIVIDE_CONQUER,
+    PLAN_THREAD_POOL
+};
+
+inline const char* planName(PlanKind kind) {
+    switch (kind) {
+    case PLAN_DIVIDE_CONQUER:
+        return "DivideConquer";
+    case PLAN_THREAD_POOL:
+        return "ThreadPool";
+    default:
+        return "Sequential";
+    }
+}
+
+struct ExecutionPlan {
+    PlanKind kind = PLAN_SEQUENTIAL;
+    int threads = 1;
+    int depth = 0;          // sólo DivideConquer
+    std::size_t grain = 0;  // elementos por hoja o por trozo
+    double predicted_ns = 0;
+};
+
+// Resultado de la calibración; sólo vale para el mismo núcleo, tipo,
+// acumulador y número de hilos con que se midió
+struct TuningProfile {
+    std::string kernel;
+    std::string element;
+    std::string accumulator;
+    int max_threads = 0;
+    double elem_ns = 0;
+    double fork_ns = 0;
+    double dispatch_ns = 0;
+    double task_ns = 0;
+
+    bool sameSetup(const TuningProfile& other) const {
+        return kernel == other.kernel && element == other.element &&
+               accumulator == other.accumulator && max_threads == other.max_threads;
+    }
+};
+
+// Formato "clave valor" por línea; las líneas con # son comentarios
+inline bool loadTuningProfile(const std::string& path, TuningProfile& profile) {
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        return false;
+    }
+    TuningProfile p;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::stringstream ss(line);
+        std::string key;
+        ss >> key;
+        if (key == "kernel") {
+            ss >> p.kernel;
+        } else if (key == "element") {
+            ss >> p.element;
+        } else if (key == "accumulator") {
+            ss >> p.accumulator;
+        } else if (key == "max_threads") {
+            ss >> p.max_threads;
+        } else if (key == "elem_ns") {
+            ss >> p.elem_ns;
+        } else if (key == "fork_ns") {
+            ss >> p.fork_ns;
+        } else if (key == "dispatch_ns") {
+            ss >> p.dispatch_ns;
+        } else if (key == "task_ns") {
+            ss >> p.task_ns;
+        }
+        if (ss.fail()) {
+            return false;
+        }
+    }
+    if (p.elem_ns <= 0 || p.max_threads < 1) {
+        return false;
+    }
+    profile = p;
+    return true;
+}
+
+inline bool saveTuningProfile(const std::string& path, const TuningProfile& p) {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        std::cerr << "Error: no se pudo abrir " << path << "\n";
+        return false;
+    }
+    out << "# Perfil de ajuste de la estrategia adaptativa (-a); bórrese para recalibrar\n"
+        << "kernel " << p.kernel << "\n"
+        << "element " << p.element << "\n"
+        << "accumulator " << p.accumulator << "\n"
+        << "max_threads " << p.max_threads << "\n"
+        << "elem_ns " << p.elem_ns << "\n"
+        << "fork_ns " << p.fork_ns << "\n"
+        << "dispatch_ns " << p.dispatch_ns << "\n"
+        << "task_ns " << p.task_ns << "\n";
+    return true;
+}
+
+// Mínimo, en ns, de varias ejecuciones de f: el mínimo descarta las
+// interrupciones del sistema, que sólo pueden alargar una medida
+template <typename F>
+double minTimeNs(F&& f, int repetitions) {
+    double best = 0;
+    for (int i = 0; i < repetitions; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        auto end = std::chrono::steady_clock::now();
+        double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        if (i == 0 || ns < best) {
+            best = ns;
+        }
+    }
+    return best;
+}
+
+// Coste por elemento del núcleo activo sobre datos como los generados
+template <typename Acc>
+double calibrateElementCost() {
+    const std::size_t n = 1 << 16; // cabe en L2: mide cálculo, no memoria
+    std::vector<Element> sample(n);
+    fillGenerated(sample.data(), 42, 0, n);
+    StatsPartial<Acc> partial;
+    double ns = minTimeNs([&] {
+        partial = StatsPartial<Acc>();
+        runStatsKernel(sample.data(), 0, n, 0, partial);
+    }, 20);
+    // Evita que el compilador descarte el cálculo
+    volatile double sink = partial.sum.value();
+    (void)sink;
+    return std::max(ns / n, 1e-3);
+}
+
+// Reparto óptimo según el perfil para n elementos y como mucho max_threads
+// hilos. Sólo se consideran repartos que las estrategias ejecutan tal cual:
+// si chunkCount daría menos trozos (por MIN_CHUNK_ELEMS) el reparto no se
+// puede hacer y los mayores tampoco, así que el plan coincide con lo que
+// corre y con lo que mide la calibración.
+inline ExecutionPlan choosePlan(const TuningProfile& profile, std::size_t n, int max_threads) {
+    ExecutionPlan best;
+    best.grain = n;
+    best.predicted_ns = n * profile.elem_ns;
+    double work = n * profile.elem_ns;
+
+    // El árbol sólo da potencias de dos; con más hojas que hilos no se gana nada
+    for (int depth = 1; depth <= 5 && (1 << (depth - 1)) < max_threads; ++depth) {
+        if (chunkCount(n, 1 << depth) < (std::size_t(1) << depth)) {
+            break;
+        }
+        int p = std::min(1 << depth, max_threads);
+        double dc = work / p + depth * profile.fork_ns;
+        if (dc < best.predicted_ns) {
+            best.kind = PLAN_DIVIDE_CONQUER;
+            best.threads = p;
+            best.depth = depth;
+            best.grain = std::max<std::size_t>((n + (1 << depth) - 1) >> depth, 1);
+            best.predicted_ns = dc;
+        }
+    }
+    for (int p = 2; p <= max_threads; ++p) {
+        if (chunkCount(n, p) < static_cast<std::size_t>(p)) {
+            break; // threadPoolPartial lanzaría menos tareas que p
+        }
+        double tp = work / p + profile.dispatch_ns + (p - 1) * profile.task_ns;
+        if (tp < best.predicted_ns) {
+            best.kind = PLAN_THREAD_POOL;
+            best.threads = p;
+            best.depth = 0;
+            best.grain = (n + p - 1) / p;
+            best.predicted_ns = tp;
+        }
+    }
+    return best;
+}
+
+#endif // ADAPTIVE_H
@@ -0,0 +1,188 @@
+#ifndef AFFINITY_H
+#define AFFINITY_H
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+#include <pthread.h>
+#include <sched.h>
+#include "benchmark.h"
+
+// Políticas de afinidad de los hilos de cálculo. Cada hilo ocupa un puesto:
+// el 0 es el hilo que reparte (main) y los workers de un pool, los puestos 1,
+// 2, ...; la política da la CPU de cada puesto:
+//   - compact: llena un núcleo (con sus hermanos SMT) antes de pasar al siguiente
+//   - scatter: un hilo por núcleo alternando paquetes, y los hermanos SMT al final
+//   - nosmt: como compact pero con un solo hilo hardware por núcleo
+//   - lista explícita (0,2,4-7): las CPUs en ese orden
+// Con más puestos que CPUs se vuelve a empezar por la primera. Sólo se usan
+// CPUs permitidas al proceso, así que se combina con --pin.
+
+struct CpuInfo {
+    int cpu = 0;
+    int package = 0;
+    int core = 0;
+    int smt = 0; // posición entre los hermanos del mismo núcleo
+};
+
+inline int readTopologyValue(int cpu, const char* name, int fallback) {
+    std::ifstream in("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/" + name);
+    int value;
+    return (in >> value) ? value : fallback;
+}
+
+// CPUs permitidas con su paquete y núcleo leídos de /sys; si no se exponen,
+// cada CPU cuenta como un núcleo propio
+inline std::vector<CpuInfo> cpuTopology() {
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    bool have_mask = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+    int limit = have_mask ? CPU_SETSIZE : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+    std::vector<CpuInfo> cpus;
+    for (int cpu = 0; cpu < limit; ++cpu) {
+        if (have_mask && !CPU_ISSET(cpu, &allowed)) {
+            continue;
+        }
+        CpuInfo info;
+        info.cpu = cpu;
+        info.package = readTopologyValue(cpu, "physical_package_id", 0);
+        info.core = readTopologyValue(cpu, "core_id", cpu);
+        cpus.push_back(info);
+    }
+    std::sort(cpus.begin(), cpus.end(), [](const CpuInfo& a, const CpuInfo& b) {
+        return std::tie(a.package, a.core, a.cpu) < std::tie(b.package, b.core, b.cpu);
+    });
+    for (std::size_t i = 1; i < cpus.size(); ++i) {
+        const CpuInfo& prev = cpus[i - 1];
+        if (cpus[i].package == prev.package && cpus[i].core == prev.core) {
+            cpus[i].smt = prev.smt + 1;
+        }
+    }
+    return cpus;
+}
+
+// Fija el hilo llamante a las CPUs dadas
+inline bool pinCurrentThread(const std::vector<int>& cpus) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        CPU_SET(cpu, &set);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+enum AffinityKind {
+    AFFINITY_NONE,
+    AFFINITY_COMPACT,
+    AFFINITY_SCATTER,
+    AFFINITY_NOSMT,
+    AFFINITY_LIST
+};
+
+class AffinityPolicy {
+    AffinityKind kind = AFFINITY_NONE;
+    std::vector<int> order; // CPU de cada puesto
+
+public:
+    // "compact", "scatter", "nosmt" o una lista de CPUs como 0,2,4-7
+    bool parse(const std::string& spec) {
+        std::vector<CpuInfo> cpus = cpuTopology();
+        order.clear();
+        if (spec == "compact" || spec == "nosmt") {
+            kind = (spec == "compact") ? AFFINITY_COMPACT : AFFINITY_NOSMT;
+            for (const CpuInfo& c : cpus) {
+                if (kind == AFFINITY_COMPACT || c.smt == 0) {
+                    order.push_back(c.cpu);
+                }
+            }
+        } else if (spec == "scatter") {
+            kind = AFFINITY_SCATTER;
+            // Rango de cada núcleo dentro de su paquete, para alternar paquetes
+            std::vector<std::tuple<int, int, int, int>> keys;
+            int rank = 0;
+            for (std::size_t i = 0; i < cpus.size(); ++i) {
+                if (i > 0 && cpus[i].package != cpus[i - 1].package) {
+                    rank = 0;
+                } else if (i > 0 && cpus[i].core != cpus[i - 1].core) {
+                    ++rank;
+                }
+                keys.emplace_back(cpus[i].smt, rank, cpus[i].package, cpus[i].cpu);
+            }
+            std::sort(keys.begin(), keys.end());
+            for (const auto& k : keys) {
+                order.push_back(std::get<3>(k));
+            }
+        } else {
+            kind = AFFINITY_LIST;
+            std::vector<long long> list;
+            if (!parseList(spec, list)) {
+                std::cerr << "Error: --affinity espera compact, scatter, nosmt o una lista de CPUs como 0,2,4-7\n";
+                return false;
+            }
+            for (long long cpu : list) {
+                bool allowed = std::any_of(cpus.begin(), cpus.end(), [cpu](const CpuInfo& c) { return c.cpu == cpu; });
+                if (!allowed) {
+                    std::cerr << "Error: CPU no disponible para el proceso: " << cpu << "\n";
+                    return false;
+                }
+                order.push_back(static_cast<int>(cpu));
+            }
+        }
+        if (order.empty()) {
+            std::cerr << "Error: ninguna CPU disponible para la afinidad " << spec << "\n";
+            return false;
+        }
+        return true;
+    }
+
+    bool enabled() const { return kind != AFFINITY_NONE; }
+
+    const char* name() const {
+        switch (kind) {
+        case AFFINITY_COMPACT:
+            return "compact";
+        case AFFINITY_SCATTER:
+            return "scatter";
+        case AFFINITY_NOSMT:
+            return "nosmt";
+        case AFFINITY_LIST:
+            return "list";
+        default:
+            return "none";
+        }
+    }
+
+    int cpuFor(int slot) const { return order[slot % order.size()]; }
+
+    // Fija el hilo llamante a la CPU de su puesto; sin política no hace nada
+    bool pinSlot(int slot) const {
+        return !enabled() || pinCurrentThread(std::vector<int>(1, cpuFor(slot)));
+    }
+
+    // Orden de CPUs de los primeros slots puestos, para mostrarlo
+    std::string describe(int slots) const {
+        std::string text;
+        for (int s = 0; s < slots && enabled(); ++s) {
+            text += (s > 0 ? "," : "") + std::to_string(cpuFor(s));
+        }
+        return text;
+    }
+
+    // Función on_start para WorkerPool y WorkStealingPool: el worker i ocupa
+    // el puesto i + 1, detrás del hilo que reparte
+    std::function<void(int)> workerStart() const {
+        if (!enabled()) {
+            return nullptr;
+        }
+        AffinityPolicy self = *this;
+        return [self](int worker) { self.pinSlot(worker + 1); };
+    }
+};
+
+#endif // AFFINITY_H
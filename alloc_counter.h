@@ -0,0 +1,62 @@
+#ifndef ALLOC_COUNTER_H
+#define ALLOC_COUNTER_H
+
+// Contador opcional de reservas de memoria: con STATS_COUNT_ALLOCS definido se
+// sustituyen los operator new globales por versiones que cuentan cada
+// llamada, y measure() informa de las reservas por llamada medida. Como
+// sustituye funciones globales, este fichero sólo debe incluirse (directa o
+// indirectamente) desde un único .cc por programa.
+
+#ifdef STATS_COUNT_ALLOCS
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+inline std::atomic<long long>& allocationCounter() {
+    static std::atomic<long long> counter(0);
+    return counter;
+}
+
+// Reservas hechas desde el inicio del programa, en todos los hilos
+inline long long allocationCount() {
+    return allocationCounter().load(std::memory_order_relaxed);
+}
+
+inline void* countedAllocate(std::size_t size, std::size_t align) {
+    allocationCounter().fetch_add(1, std::memory_order_relaxed);
+    if (size == 0) {
+        size = 1;
+    }
+    void* p = nullptr;
+    if (align <= alignof(std::max_align_t)) {
+        p = std::malloc(size);
+    } else if (posix_memalign(&p, align, size) != 0) {
+        p = nullptr;
+    }
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new(std::size_t size) { return countedAllocate(size, 0); }
+void* operator new[](std::size_t size) { return countedAllocate(size, 0); }
+void* operator new(std::size_t size, std::align_val_t a) { return countedAllocate(size, static_cast<std::size_t>(a)); }
+void* operator new[](std::size_t size, std::align_val_t a) { return countedAllocate(size, static_cast<std::size_t>(a)); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+#else
+
+inline long long allocationCount() { return -1; }
+
+#endif // STATS_COUNT_ALLOCS
+
+#endif // ALLOC_COUNTER_H
@@ -0,0 +1,132 @@
+#ifndef ASYNC_STATS_H
+#define ASYNC_STATS_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "chunking.h"
+#include "dataset.h"
+#include "stats_partial.h"
+#include "stats_task.h"
+#include "worker_pool.h"
+
+// Resultado futuro de tipo R. get() bloquea hasta que esté listo; then(f)
+// encadena f(R), que se ejecuta en el hilo que completa el valor (o en el
+// llamante si ya estaba listo) y devuelve el futuro de su resultado. La
+// continuación debe devolver un valor.
+template <typename R>
+class StatsFuture {
+    struct State {
+        std::mutex mutex;
+        std::condition_variable done;
+        bool ready = false;
+        R value{};
+        std::vector<std::function<void(const R&)>> continuations;
+    };
+    std::shared_ptr<State> state;
+
+public:
+    StatsFuture() : state(std::make_shared<State>()) {}
+
+    bool ready() const {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        return state->ready;
+    }
+
+    const R& get() const {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->done.wait(lock, [this] { return state->ready; });
+        return state->value;
+    }
+
+    // Publica el valor y ejecuta las continuaciones pendientes
+    void set(const R& value) const {
+        std::vector<std::function<void(const R&)>> pending;
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->value = value;
+            state->ready = true;
+            pending.swap(state->continuations);
+        }
+        state->done.notify_all();
+        for (auto& c : pending) {
+            c(state->value);
+        }
+    }
+
+    template <typename F>
+    auto then(F f) const -> StatsFuture<decltype(f(std::declval<const R&>()))> {
+        StatsFuture<decltype(f(std::declval<const R&>()))> next;
+        std::function<void(const R&)> run = [f, next](const R& value) { next.set(f(value)); };
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (!state->ready) {
+                state->continuations.push_back(std::move(run));
+                return next;
+            }
+        }
+        run(state->value);
+        return next;
+    }
+};
+
+// Lanza el cálculo de data troceado para workers hilos sin esperar: cada
+// trozo se encola con submit(std::function<void()>) y el último en terminar
+// hace la reducción y completa el futuro, así que ningún hilo se queda
+// bloqueado esperando. data debe seguir vivo hasta que el futuro esté listo.
+template <typename Acc, typename T, typename Submit>
+StatsFuture<StatsPartial<Acc>> statsPartialAsync(Submit submit, int workers, DataSpan<T> data) {
+    struct Job {
+        std::vector<StatsPartial<Acc>> partials;
+        std::vector<StatsTask<T, Acc>> tasks;
+        std::atomic<std::size_t> remaining{0};
+        StatsFuture<StatsPartial<Acc>> future;
+    };
+
+    std::shared_ptr<Job> job = std::make_shared<Job>();
+    std::size_t num_tasks = chunkCount(data.size(), workers);
+    job->partials.resize(num_tasks);
+    job->tasks.reserve(num_tasks);
+    for (std::size_t i = 0; i < num_tasks; ++i) {
+        job->tasks.emplace_back(data, chunkBoundary(data.ptr, data.size(), num_tasks, i),
+                                chunkBoundary(data.ptr, data.size(), num_tasks, i + 1), job->partials[i]);
+    }
+    job->remaining.store(num_tasks, std::memory_order_relaxed);
+
+    StatsFuture<StatsPartial<Acc>> future = job->future;
+    for (std::size_t i = 0; i < num_tasks; ++i) {
+        job->tasks[i].markEnqueued();
+        submit([job, i] {
+            job->tasks[i].computeMetrics();
+            if (job->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                job->future.set(reducePartials(job->partials));
+            }
+        });
+    }
+    return future;
+}
+
+// Igual que statsPartialAsync, con la finalización encadenada como continuación
+template <typename Acc, typename T, typename Submit>
+StatsFuture<StatsResult> statsAsync(Submit submit, int workers, DataSpan<T> data) {
+    return statsPartialAsync<Acc>(submit, workers, data).then([](const StatsPartial<Acc>& total) {
+        StatsResult r;
+        if (total.count > 0) {
+            finalizeStats(total, r.mode, r.stddev, r.sum);
+        }
+        return r;
+    });
+}
+
+// Adaptador de WorkerPool para statsAsync
+inline std::function<void(std::function<void()>)> poolSubmitter(WorkerPool& pool) {
+    return [&pool](std::function<void()> task) { pool.submit(std::move(task)); };
+}
+
+#endif // ASYNC_STATS_H
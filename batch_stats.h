@@ -0,0 +1,103 @@
+#ifndef BATCH_STATS_H
+#define BATCH_STATS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include "chunking.h"
+#include "dataset.h"
+#include "stats_partial.h"
+#include "stats_task.h"
+#include "worker_pool.h"
+
+// Estadísticas de muchas series en un único envío al pool. Las series mayores
+// que grain se trocean (ver chunking.h); las menores se empaquetan juntas en
+// una misma tarea hasta sumar grain elementos, de modo que miles de series
+// diminutas no pagan una tarea ni una sincronización cada una. El hilo
+// llamante también ejecuta tareas mientras espera.
+template <typename Acc, typename T>
+std::vector<StatsResult> batchStats(WorkerPool& pool, const std::vector<DataSpan<T>>& series,
+                                    std::size_t grain) {
+    struct Piece {
+        std::size_t series;
+        std::size_t start, end;
+    };
+
+    grain = std::max<std::size_t>(grain, 1);
+    std::vector<Piece> pieces;
+    std::vector<std::size_t> task_begin; // primera pieza de cada tarea
+    std::size_t packed = 0;              // elementos en la tarea abierta de series pequeñas
+    int workers = pool.size() + 1;
+
+    for (std::size_t s = 0; s < series.size(); ++s) {
+        std::size_t n = series[s].size();
+        if (n == 0) {
+            continue;
+        }
+        if (n > grain) {
+            std::size_t chunks = chunkCount(n, workers, 1, grain);
+            for (std::size_t c = 0; c < chunks; ++c) {
+                task_begin.push_back(pieces.size());
+                pieces.push_back({s, chunkBoundary(series[s].ptr, n, chunks, c),
+                                  chunkBoundary(series[s].ptr, n, chunks, c + 1)});
+            }
+            packed = grain; // lo siguiente abre tarea nueva
+            continue;
+        }
+        if (task_begin.empty() || packed + n > grain) {
+            task_begin.push_back(pieces.size());
+            packed = 0;
+        }
+        pieces.push_back({s, 0, n});
+        packed += n;
+    }
+    task_begin.push_back(pieces.size());
+
+    std::vector<StatsPartial<Acc>> partials(pieces.size());
+    auto runTask = [&](std::size_t t) {
+        for (std::size_t p = task_begin[t]; p < task_begin[t + 1]; ++p) {
+            const Piece& piece = pieces[p];
+            StatsTask<T, Acc>(series[piece.series], piece.start, piece.end, partials[p]).computeMetrics();
+        }
+    };
+
+    std::size_t num_tasks = task_begin.size() - 1;
+    for (std::size_t t = 1; t < num_tasks; ++t) {
+        pool.submit([&runTask, t] { runTask(t); });
+    }
+    if (num_tasks > 0) {
+        runTask(0);
+    }
+    while (pool.runPendingTask()) {
+    }
+    pool.wait();
+
+    // Las piezas de una serie son consecutivas; se combinan en árbol
+    std::vector<StatsResult> results(series.size());
+    std::vector<StatsPartial<Acc>> group;
+    for (std::size_t p = 0; p < pieces.size();) {
+        std::size_t s = pieces[p].series;
+        group.clear();
+        for (; p < pieces.size() && pieces[p].series == s; ++p) {
+            group.push_back(partials[p]);
+        }
+        StatsResult& r = results[s];
+        finalizeStats(reducePartials(group), r.mode, r.stddev, r.sum);
+    }
+    return results;
+}
+
+// Corta data en count series contiguas de tamaño equilibrado
+template <typename T>
+std::vector<DataSpan<T>> splitSeries(DataSpan<T> data, std::size_t count) {
+    std::vector<DataSpan<T>> series(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        std::size_t start = data.size() / count * i + data.size() % count * i / count;
+        std::size_t end = data.size() / count * (i + 1) + data.size() % count * (i + 1) / count;
+        series[i].ptr = data.ptr + start;
+        series[i].count = end - start;
+    }
+    return series;
+}
+
+#endif // BATCH_STATS_H
@@ -0,0 +1,30 @@
+#!/bin/sh
+# Microbenchmarks (microbench.cc) con los resultados en JSON para comparar
+# entre commits.
+# Uso: ./bench.sh [DIRECTORIO_DE_COMPILACIÓN] [OPCIONES DE stats_bench...]
+#   (QMAKE=qmake6 para Qt 6; BASELINE=FICHERO.json compara con otra ejecución)
+# Deja bench-<commit>.json en el directorio de compilación. La comparación
+# usa tools/compare.py de Google Benchmark (COMPARE=ruta si no está en PATH).
+set -e
+SRC=$(cd "$(dirname "$0")" && pwd)
+BUILD=${1:-build-bench}
+[ $# -gt 0 ] && shift
+QMAKE=${QMAKE:-qmake}
+COMPARE=${COMPARE:-compare.py}
+JOBS=$(nproc 2>/dev/null || echo 2)
+COMMIT=$(git -C "$SRC" rev-parse --short HEAD 2>/dev/null || echo local)
+
+mkdir -p "$BUILD"
+cd "$BUILD"
+$QMAKE "$SRC/qthreadpool.pro" CONFIG+=gbench
+make -j"$JOBS"
+
+# Varias repeticiones para que la comparación tenga mediana y dispersión
+OUT="$(pwd)/bench-$COMMIT.json"
+./stats_bench --benchmark_repetitions=5 --benchmark_report_aggregates_only=true \
+              --benchmark_out="$OUT" --benchmark_out_format=json "$@"
+echo "Resultados en $OUT"
+
+if [ -n "$BASELINE" ]; then
+    $COMPARE benchmarks "$BASELINE" "$OUT"
+fi
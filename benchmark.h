@@ -0,0 +1,272 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sched.h>
+#include "alloc_counter.h"
+
+// Arnés de medición: calentamiento, repeticiones configurables, resolución
+// de nanosegundos y resumen estadístico de las muestras.
+struct BenchOptions {
+    int warmup = 1;
+    int repetitions = 5;
+    std::string pin;                  // lista de CPUs ("0-3,8"), vacía = sin fijar
+    std::vector<long long> sweep;     // valores de -d/-p/-w a recorrer
+    std::vector<std::size_t> sizes;   // valores de N a recorrer
+    std::string output;               // fichero .json o .csv, vacío = ninguno
+};
+
+struct BenchSummary {
+    long long min_ns = 0;
+    long long median_ns = 0;
+    long long p90_ns = 0;
+    long long p99_ns = 0;
+    double mean_ns = 0;
+    double stddev_ns = 0;
+    double allocs_per_call = -1; // -1 si no se cuentan (ver alloc_counter.h)
+};
+
+// Una fila de resultados con todos los parámetros de la ejecución
+struct BenchRecord {
+    std::string strategy;
+    long long param = 0;    // valor de -d, -p o -w
+    int threads = 0;
+    std::size_t n = 0;
+    std::size_t grain = 0;
+    std::string kernel;
+    std::size_t prefetch = 0; // distancia de prefetch software en bytes
+    std::string affinity = "none"; // política de --affinity
+    std::string element;      // tipo de los datos (STATS_ELEMENT)
+    std::string accumulator;  // política de acumulación (STATS_ACCUMULATOR)
+    int warmup = 0;
+    int repetitions = 0;
+    BenchSummary summary;
+};
+
+inline std::string compilerName() {
+#if defined(__clang__)
+    return "clang " __clang_version__;
+#elif defined(__GNUC__)
+    return "gcc " __VERSION__;
+#else
+    return "unknown";
+#endif
+}
+
+// Percentil por rango más cercano sobre muestras ya ordenadas
+inline long long percentile(const std::vector<long long>& sorted, double p) {
+    std::size_t rank = static_cast<std::size_t>(std::ceil(p * sorted.size()));
+    return sorted[std::min(sorted.size(), std::max<std::size_t>(rank, 1)) - 1];
+}
+
+inline BenchSummary summarize(std::vector<long long> samples) {
+    BenchSummary s;
+    if (samples.empty()) {
+        return s;
+    }
+    std::sort(samples.begin(), samples.end());
+    s.min_ns = samples.front();
+    s.median_ns = percentile(samples, 0.5);
+    s.p90_ns = percentile(samples, 0.9);
+    s.p99_ns = percentile(samples, 0.99);
+    double total = 0;
+    for (long long v : samples) {
+        total += v;
+    }
+    s.mean_ns = total / samples.size();
+    double sq = 0;
+    for (long long v : samples) {
+        sq += (v - s.mean_ns) * (v - s.mean_ns);
+    }
+    s.stddev_ns = samples.size() > 1 ? std::sqrt(sq / (samples.size() - 1)) : 0.0;
+    return s;
+}
+
+// Impide que el compilador descarte el cálculo que produce value: el asm
+// vacío "lee" value y puede tocar memoria, así que hay que tenerlo calculado
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Cota de cordura del bucle medido: ningún núcleo procesa un elemento en
+// menos de MIN_NS_PER_ELEMENT ns, así que un tiempo menor con n grande
+// significa que el cálculo se ha eliminado o no se ha hecho
+const double MIN_NS_PER_ELEMENT = 0.05;
+const std::size_t MIN_CHECKED_ELEMENTS = 1 << 16;
+
+inline bool timingPlausible(const BenchSummary& s, std::size_t n, int threads) {
+    if (n < MIN_CHECKED_ELEMENTS) {
+        return true; // domina el coste fijo de la llamada
+    }
+    return s.min_ns >= n * MIN_NS_PER_ELEMENT / std::max(threads, 1);
+}
+
+inline void warnImplausibleTiming(const BenchRecord& r) {
+    if (!timingPlausible(r.summary, r.n, r.threads)) {
+        std::cerr << "Aviso: " << r.strategy << " tardó " << r.summary.min_ns << " ns con n = " << r.n
+                  << "; el bucle medido parece eliminado por el compilador\n";
+    }
+}
+
+// Ejecuta f warmup veces sin medir y luego repetitions veces midiendo cada
+// llamada. Las barreras evitan que el compilador mueva trabajo fuera de la
+// región medida. f devuelve false para abortar. Con STATS_COUNT_ALLOCS se
+// cuentan además las reservas de memoria de las llamadas medidas.
+template <typename F>
+bool measure(F&& f, int warmup, int repetitions, BenchSummary& summary) {
+    for (int i = 0; i < warmup; ++i) {
+        if (!f()) {
+            return false;
+        }
+    }
+    std::vector<long long> samples;
+    samples.reserve(repetitions);
+    long long allocs_before = allocationCount();
+    for (int i = 0; i < repetitions; ++i) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto start = std::chrono::steady_clock::now();
+        bool ok = f();
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto end = std::chrono::steady_clock::now();
+        if (!ok) {
+            return false;
+        }
+        samples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
+    long long allocs_after = allocationCount();
+    summary = summarize(samples);
+    if (allocs_before >= 0 && repetitions > 0) {
+        summary.allocs_per_call = static_cast<double>(allocs_after - allocs_before) / repetitions;
+    }
+    return true;
+}
+
+// Lista separada por comas de enteros; admite rangos "a-b" (p. ej. "1,2,4-8")
+inline bool parseList(const std::string& text, std::vector<long long>& values) {
+    values.clear();
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (item.empty()) {
+            return false;
+        }
+        char* rest = nullptr;
+        long long first = std::strtoll(item.c_str(), &rest, 10);
+        long long last = first;
+        if (*rest == '-') {
+            last = std::strtoll(rest + 1, &rest, 10);
+        }
+        if (*rest != '\0' || last < first) {
+            return false;
+        }
+        for (long long v = first; v <= last; ++v) {
+            values.push_back(v);
+        }
+    }
+    return !values.empty();
+}
+
+// Fija el proceso a las CPUs indicadas; los hilos creados después heredan
+// la máscara, así que hay que llamarlo antes de crear los pools.
+inline bool pinToCpus(const std::string& cpus) {
+    std::vector<long long> list;
+    if (!parseList(cpus, list)) {
+        std::cerr << "Error: lista de CPUs inválida: " << cpus << "\n";
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (long long cpu : list) {
+        if (cpu < 0 || cpu >= CPU_SETSIZE) {
+            std::cerr << "Error: CPU fuera de rango: " << cpu << "\n";
+            return false;
+        }
+        CPU_SET(cpu, &set);
+    }
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+        std::cerr << "Error: no se pudo fijar la afinidad a " << cpus << "\n";
+        return false;
+    }
+    return true;
+}
+
+inline bool endsWith(const std::string& s, const std::string& suffix) {
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+inline std::string jsonEscape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+        }
+        out += c;
+    }
+    return out;
+}
+
+// Escribe los registros en JSON (si path termina en .json) o en CSV; el
+// CSV se añade al final y sólo lleva cabecera si el fichero estaba vacío.
+inline bool writeBenchRecords(const std::string& path, const std::vector<BenchRecord>& records) {
+    std::string compiler = compilerName();
+    if (endsWith(path, ".json")) {
+        std::ofstream out(path);
+        if (!out.is_open()) {
+            std::cerr << "Error: no se pudo abrir " << path << "\n";
+            return false;
+        }
+        out << "[\n";
+        for (std::size_t i = 0; i < records.size(); ++i) {
+            const BenchRecord& r = records[i];
+            out << "  {\"strategy\": \"" << r.strategy << "\", \"param\": " << r.param
+                << ", \"threads\": " << r.threads << ", \"n\": " << r.n
+                << ", \"grain\": " << r.grain << ", \"kernel\": \"" << r.kernel
+                << "\", \"prefetch\": " << r.prefetch << ", \"affinity\": \"" << r.affinity << "\", \"element\": \"" << r.element << "\", \"accumulator\": \"" << r.accumulator
+                << "\", \"compiler\": \"" << jsonEscape(compiler) << "\", \"warmup\": " << r.warmup
+                << ", \"repetitions\": " << r.repetitions
+                << ", \"min_ns\": " << r.summary.min_ns << ", \"median_ns\": " << r.summary.median_ns
+                << ", \"p90_ns\": " << r.summary.p90_ns << ", \"p99_ns\": " << r.summary.p99_ns
+                << ", \"mean_ns\": " << r.summary.mean_ns << ", \"stddev_ns\": " << r.summary.stddev_ns
+                << ", \"allocs_per_call\": " << r.summary.allocs_per_call
+                << "}" << (i + 1 < records.size() ? "," : "") << "\n";
+        }
+        out << "]\n";
+        return true;
+    }
+
+    bool empty;
+    {
+        std::ifstream in(path);
+        empty = !in.is_open() || in.peek() == std::ifstream::traits_type::eof();
+    }
+    std::ofstream out(path, std::ios::app);
+    if (!out.is_open()) {
+        std::cerr << "Error: no se pudo abrir " << path << "\n";
+        return false;
+    }
+    if (empty) {
+        out << "strategy,param,threads,n,grain,kernel,prefetch,affinity,element,accumulator,compiler,warmup,repetitions,"
+               "min_ns,median_ns,p90_ns,p99_ns,mean_ns,stddev_ns,allocs_per_call\n";
+    }
+    for (const BenchRecord& r : records) {
+        out << r.strategy << "," << r.param << "," << r.threads << "," << r.n << ","
+            << r.grain << "," << r.kernel << "," << r.prefetch << "," << r.affinity << "," << r.element << "," << r.accumulator << ",\"" << compiler << "\"," << r.warmup << ","
+            << r.repetitions << "," << r.summary.min_ns << "," << r.summary.median_ns << ","
+            << r.summary.p90_ns << "," << r.summary.p99_ns << "," << r.summary.mean_ns << ","
+            << r.summary.stddev_ns << "," << r.summary.allocs_per_call << "\n";
+    }
+    return true;
+}
+
+#endif // BENCHMARK_H
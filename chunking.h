@@ -0,0 +1,61 @@
+#ifndef CHUNKING_H
+#define CHUNKING_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+// Política de troceado común a todas las estrategias: el número de trozos se
+// acota según los workers y un tamaño mínimo de trozo, y las fronteras caen
+// en múltiplos de línea de caché (de página en modo NUMA, de página enorme
+// con trozos grandes) de la dirección real de los datos, así que dos trozos
+// nunca comparten línea. Todo se calcula en std::size_t sin productos que
+// puedan desbordar.
+
+const std::size_t CACHE_LINE_BYTES = 64;
+const std::size_t PAGE_BYTES = 4096;
+const std::size_t HUGE_PAGE_BYTES = 2 << 20;
+
+// Con trozos de al menos tantos bytes las fronteras pasan a páginas enormes:
+// cada trozo usa entonces sus propias entradas de TLB y el redondeo no
+// desequilibra el reparto más de un 1/8
+const std::size_t HUGE_CHUNK_BYTES = 8 * HUGE_PAGE_BYTES;
+
+// Por debajo de este número de elementos una tarea cuesta más de lo que calcula
+const std::size_t MIN_CHUNK_ELEMS = 1024;
+
+// Trozos para n elementos entre workers hilos, con hasta tasks_per_worker
+// trozos por hilo y ninguno menor que min_chunk (salvo si n es menor)
+inline std::size_t chunkCount(std::size_t n, int workers, int tasks_per_worker = 1,
+                              std::size_t min_chunk = MIN_CHUNK_ELEMS) {
+    std::size_t max_tasks = static_cast<std::size_t>(std::max(1, workers)) * std::max(1, tasks_per_worker);
+    min_chunk = std::max<std::size_t>(min_chunk, 1);
+    std::size_t by_size = n / min_chunk + (n % min_chunk != 0);
+    return std::max<std::size_t>(1, std::min(max_tasks, by_size));
+}
+
+// Alineación de las fronteras de count trozos de n elementos de bytes bytes
+inline std::size_t chunkAlignment(std::size_t n, std::size_t count, std::size_t bytes) {
+    return n / std::max<std::size_t>(count, 1) >= HUGE_CHUNK_BYTES / bytes ? HUGE_PAGE_BYTES : CACHE_LINE_BYTES;
+}
+
+// Frontera i (de 0 a count) de count trozos equilibrados sobre data[0, n),
+// redondeada hacia abajo a un múltiplo de align_bytes en memoria; con 0 se
+// elige según el tamaño de los trozos (chunkAlignment)
+template <typename T>
+std::size_t chunkBoundary(const T* data, std::size_t n, std::size_t count, std::size_t i,
+                          std::size_t align_bytes = 0) {
+    if (i >= count) {
+        return n;
+    }
+    if (align_bytes == 0) {
+        align_bytes = chunkAlignment(n, count, sizeof(T));
+    }
+    std::size_t b = n / count * i + n % count * i / count;
+    std::size_t align = std::max<std::size_t>(1, align_bytes / sizeof(T));
+    std::size_t skew = (reinterpret_cast<std::uintptr_t>(data) % align_bytes) / sizeof(T);
+    std::size_t aligned = (b + skew) / align * align;
+    return aligned > skew ? std::min(n, aligned - skew) : 0;
+}
+
+#endif // CHUNKING_H
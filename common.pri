@@ -0,0 +1,74 @@
+# Opciones comunes a stats (main.cc) y stats_pool (maincontodo.cc)
+QT += core
+CONFIG += c++17 release
+CONFIG -= debug_and_release
+HEADERS += $$PWD/accumulator.h $$PWD/adaptive.h $$PWD/affinity.h $$PWD/alloc_counter.h $$PWD/async_stats.h \
+           $$PWD/batch_stats.h $$PWD/benchmark.h $$PWD/chunking.h $$PWD/coro_stats.h $$PWD/dataset.h \
+           $$PWD/divide_conquer.h $$PWD/exact_partial.h $$PWD/exact_stats.h $$PWD/gpu_stats.h $$PWD/histogram.h $$PWD/latch.h $$PWD/metrics.h $$PWD/mpi_stats.h \
+           $$PWD/numa.h $$PWD/scheduler.h $$PWD/sliding_stats.h $$PWD/stats_kernel.h $$PWD/stats_partial.h \
+           $$PWD/stats_task.h $$PWD/stats_types.h $$PWD/stream_stats.h $$PWD/task_arena.h \
+           $$PWD/trace.h $$PWD/work_stealing.h $$PWD/worker_pool.h
+
+# Release: -O3 para la CPU de la máquina y LTO. Con CONFIG+=portable no se
+# usa -march=native (binarios para otras máquinas; los núcleos SIMD se
+# eligen igualmente en tiempo de ejecución).
+QMAKE_CXXFLAGS_RELEASE -= -O2
+QMAKE_CXXFLAGS_RELEASE += -O3
+!portable {
+    QMAKE_CXXFLAGS_RELEASE += -march=native
+}
+!no_lto {
+    CONFIG += ltcg
+}
+
+# PGO en dos fases (ver pgo.sh): pgo_gen instrumenta y las ejecuciones de
+# entrenamiento escriben los perfiles en PGO_DIR; pgo_use compila con ellos
+isEmpty(PGO_DIR) {
+    PGO_DIR = $$OUT_PWD/pgo-data
+}
+pgo_gen {
+    QMAKE_CXXFLAGS += -fprofile-generate=$$PGO_DIR
+    QMAKE_LFLAGS += -fprofile-generate=$$PGO_DIR
+}
+pgo_use {
+    QMAKE_CXXFLAGS += -fprofile-use=$$PGO_DIR -fprofile-correction -Wno-missing-profile
+    QMAKE_LFLAGS += -fprofile-use=$$PGO_DIR
+}
+
+# qmake CONFIG+=trace: instrumentación por tarea, volcada con --trace FICHERO
+trace {
+    DEFINES += STATS_TRACE
+}
+
+# qmake CONFIG+=allocs: cuenta las reservas de memoria por llamada medida
+allocs {
+    DEFINES += STATS_COUNT_ALLOCS
+}
+
+# qmake CONFIG+=coro: compila con C++20 y habilita la estrategia con corrutinas
+coro {
+    CONFIG -= c++17
+    CONFIG += c++2a
+}
+
+# qmake CONFIG+=mpi: modo distribuido --mpi, compilado con el envoltorio de MPI
+mpi {
+    DEFINES += STATS_WITH_MPI OMPI_SKIP_MPICXX MPICH_SKIP_MPICXX # sin los enlaces C++ obsoletos
+    QMAKE_CXX = mpicxx
+    QMAKE_LINK = mpicxx
+}
+
+# qmake CONFIG+=openmp: añade el planificador OpenMP a --scheduler
+openmp {
+    QMAKE_CXXFLAGS += -fopenmp
+    QMAKE_LFLAGS += -fopenmp
+}
+
+# qmake CONFIG+=pstl: añade el planificador std::execution::par (TBB en GCC)
+pstl {
+    DEFINES += STATS_WITH_PSTL
+    LIBS += -ltbb
+}
+
+# Tipo de los datos y política de acumulación (ver stats_types.h), p. ej.
+# qmake "DEFINES+=STATS_ELEMENT=float STATS_ACCUMULATOR=KahanAccumulator"
@@ -0,0 +1,223 @@
+#ifndef CORO_STATS_H
+#define CORO_STATS_H
+
+// Ejecución con corrutinas de C++20: cada rango es una corrutina que se
+// divide en dos hijas, reanuda la derecha en el pool y la izquierda en línea,
+// y espera (co_await) a ambas sin bloquear el hilo: la última hija en acabar
+// reanuda a la madre. Los marcos de las corrutinas salen de una caché de
+// bloques por hilo en lugar de un new/delete por tarea. Sólo se compila con
+// soporte de corrutinas (qmake CONFIG+=coro); si no, STATS_HAVE_COROUTINES
+// queda sin definir.
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#define STATS_HAVE_COROUTINES 1
+
+#include <algorithm>
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <iostream>
+#include <new>
+#include <utility>
+#include <vector>
+#include "chunking.h"
+#include "dataset.h"
+#include "stats_partial.h"
+#include "stats_task.h"
+#include "worker_pool.h"
+
+// Caché de marcos por hilo, en clases de 64 bytes hasta 1 KiB. Un marco puede
+// liberarse en otro hilo; entonces pasa a la caché de ese hilo. Los bloques
+// se alinean a ALIGNMENT: el promise guarda un StatsPartial alignas(64) y
+// ::operator new(size) sólo garantiza 16 bytes.
+class FrameCache {
+public:
+    static const std::size_t ALIGNMENT = 64;
+
+private:
+    static const std::size_t CLASS_BYTES = 64;
+    static const std::size_t CLASSES = 16;
+    static const std::size_t MAX_CACHED = 1024;
+
+    std::vector<void*> free_blocks[CLASSES];
+
+    static FrameCache& local() {
+        thread_local FrameCache cache;
+        return cache;
+    }
+
+public:
+    ~FrameCache() {
+        for (auto& list : free_blocks) {
+            for (void* p : list) {
+                ::operator delete(p, std::align_val_t(ALIGNMENT));
+            }
+        }
+    }
+
+    static void* allocate(std::size_t size) {
+        std::size_t c = (size + CLASS_BYTES - 1) / CLASS_BYTES;
+        if (c == 0 || c > CLASSES) {
+            return ::operator new(size, std::align_val_t(ALIGNMENT));
+        }
+        std::vector<void*>& list = local().free_blocks[c - 1];
+        if (list.empty()) {
+            return ::operator new(c * CLASS_BYTES, std::align_val_t(ALIGNMENT));
+        }
+        void* p = list.back();
+        list.pop_back();
+        return p;
+    }
+
+    static void release(void* p, std::size_t size) {
+        std::size_t c = (size + CLASS_BYTES - 1) / CLASS_BYTES;
+        if (c == 0 || c > CLASSES) {
+            ::operator delete(p, std::align_val_t(ALIGNMENT));
+            return;
+        }
+        std::vector<void*>& list = local().free_blocks[c - 1];
+        if (list.size() >= MAX_CACHED) {
+            ::operator delete(p, std::align_val_t(ALIGNMENT));
+            return;
+        }
+        list.push_back(p);
+    }
+};
+
+// Punto de encuentro de las dos hijas: 2 hijas + la propia suspensión de la madre
+struct CoroJoin {
+    std::atomic<int> pending{3};
+    std::coroutine_handle<> parent;
+};
+
+// Corrutina perezosa con resultado R; empieza al reanudarla
+template <typename R>
+class CoroTask {
+public:
+    struct promise_type {
+        R value{};
+        CoroJoin* join = nullptr;           // sincronización con la madre
+        std::atomic<bool>* done = nullptr;  // sólo en la raíz
+
+        static void* operator new(std::size_t size) { return FrameCache::allocate(size); }
+        static void operator delete(void* p, std::size_t size) { FrameCache::release(p, size); }
+
+        CoroTask get_return_object() {
+            return CoroTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        struct FinalAwaiter {
+            bool await_ready() noexcept { return false; }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+                promise_type& p = h.promise();
+                if (p.done) {
+                    p.done->store(true, std::memory_order_release);
+                } else if (p.join && p.join->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    return p.join->parent; // la última en terminar reanuda a la madre
+                }
+                return std::noop_coroutine();
+            }
+            void await_resume() noexcept {}
+        };
+        FinalAwaiter final_suspend() noexcept { return {}; }
+
+        void return_value(const R& v) { value = v; }
+        void unhandled_exception() { std::terminate(); }
+    };
+    static_assert(alignof(promise_type) <= FrameCache::ALIGNMENT,
+                  "los marcos de FrameCache no alinean lo bastante el promise");
+
+    CoroTask(CoroTask&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    CoroTask(const CoroTask&) = delete;
+    CoroTask& operator=(const CoroTask&) = delete;
+    ~CoroTask() {
+        if (handle) {
+            handle.destroy();
+        }
+    }
+
+    std::coroutine_handle<promise_type> handle;
+
+    const R& result() const { return handle.promise().value; }
+
+private:
+    explicit CoroTask(std::coroutine_handle<promise_type> h) : handle(h) {}
+};
+
+// co_await joinBoth(pool, left, right): right se reanuda en el pool, left en
+// este hilo, y la madre continúa cuando ambas han terminado
+template <typename R>
+struct JoinBothAwaiter {
+    WorkerPool& pool;
+    CoroTask<R>& left;
+    CoroTask<R>& right;
+    CoroJoin join;
+
+    bool await_ready() noexcept { return false; }
+    bool await_suspend(std::coroutine_handle<> parent) {
+        join.parent = parent;
+        left.handle.promise().join = &join;
+        right.handle.promise().join = &join;
+        std::coroutine_handle<> r = right.handle;
+        pool.submit([r] { r.resume(); });
+        left.handle.resume();
+        // Si las hijas ya terminaron, la madre sigue sin suspenderse
+        return join.pending.fetch_sub(1, std::memory_order_acq_rel) != 1;
+    }
+    void await_resume() noexcept {}
+};
+
+template <typename R>
+JoinBothAwaiter<R> joinBoth(WorkerPool& pool, CoroTask<R>& left, CoroTask<R>& right) {
+    return {pool, left, right, {}};
+}
+
+// Igual que splitRange, pero con corrutinas en lugar de helpUntil
+template <typename Acc, typename T>
+CoroTask<StatsPartial<Acc>> coroSplitRange(WorkerPool& pool, DataSpan<T> data, std::size_t start,
+                                           std::size_t end, int depth, std::size_t grain) {
+    std::size_t mid = start + chunkBoundary(data.ptr + start, end - start, 2, 1);
+    if (depth == 0 || end - start <= grain || mid == start) {
+        StatsPartial<Acc> result;
+        StatsTask<T, Acc>(data, start, end, result).computeMetrics();
+        co_return result;
+    }
+
+    CoroTask<StatsPartial<Acc>> left = coroSplitRange<Acc>(pool, data, start, mid, depth - 1, grain);
+    CoroTask<StatsPartial<Acc>> right = coroSplitRange<Acc>(pool, data, mid, end, depth - 1, grain);
+    co_await joinBoth(pool, left, right);
+
+    StatsPartial<Acc> result = left.result();
+    result.merge(right.result());
+    co_return result;
+}
+
+// Coroutine strategy: el llamante arranca la raíz y ayuda al pool hasta que acaba
+template <typename Acc, typename T>
+void coroutineStats(WorkerPool& pool, DataSpan<T> data, int splits, std::size_t grain,
+                    double& mode, double& stddev, ProductValue& sum) {
+    if (data.empty()) {
+        mode = 0;
+        stddev = 0;
+        sum = ProductValue();
+        return;
+    }
+
+    if (splits < 0 || splits > 32) {
+        std::cerr << "Error: la profundidad de división debe estar entre 0 y 32\n";
+        return;
+    }
+
+    std::atomic<bool> done(false);
+    CoroTask<StatsPartial<Acc>> root = coroSplitRange<Acc>(pool, data, 0, data.size(), splits,
+                                                           std::max<std::size_t>(grain, 1));
+    root.handle.promise().done = &done;
+    root.handle.resume();
+    pool.helpUntil(done);
+    finalizeStats(root.result(), mode, stddev, sum);
+}
+
+#endif // __cpp_impl_coroutine
+
+#endif // CORO_STATS_H
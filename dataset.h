@@ -0,0 +1,211 @@
+#ifndef DATASET_H
+#define DATASET_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "chunking.h"
+#include "stats_types.h"
+
+// Vista de sólo lectura sobre los datos: apunta a un vector generado o a las
+// páginas de un fichero proyectado con mmap, sin copias.
+template <typename T>
+struct DataSpan {
+    const T* ptr = nullptr;
+    std::size_t count = 0;
+
+    bool empty() const { return count == 0; }
+    std::size_t size() const { return count; }
+    const T& operator[](std::size_t i) const { return ptr[i]; }
+};
+
+// Fichero binario de valores Element (orden de bytes nativo) proyectado en memoria
+class MappedFile {
+    void* addr = MAP_FAILED;
+    std::size_t length = 0;
+
+public:
+    MappedFile() = default;
+    ~MappedFile() {
+        if (addr != MAP_FAILED) {
+            munmap(addr, length);
+        }
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Sustituye la proyección anterior, si la había
+    bool open(const std::string& path) {
+        if (addr != MAP_FAILED) {
+            munmap(addr, length);
+            addr = MAP_FAILED;
+            length = 0;
+        }
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            std::cerr << "Error: no se pudo abrir " << path << "\n";
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size % sizeof(Element) != 0) {
+            std::cerr << "Error: " << path << " no contiene un número entero de valores "
+                      << elementName<Element>() << "\n";
+            ::close(fd);
+            return false;
+        }
+        length = st.st_size;
+        if (length > 0) {
+            addr = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        ::close(fd); // la proyección sigue siendo válida tras cerrar
+        if (length > 0 && addr == MAP_FAILED) {
+            std::cerr << "Error: mmap de " << path << " falló\n";
+            return false;
+        }
+        if (length > 0) {
+            madvise(addr, length, MADV_SEQUENTIAL);
+        }
+        return true;
+    }
+
+    DataSpan<Element> span() const {
+        DataSpan<Element> s;
+        if (addr != MAP_FAILED) {
+            s.ptr = static_cast<const Element*>(addr);
+            s.count = length / sizeof(Element);
+        }
+        return s;
+    }
+};
+
+// Generador basado en contador (SplitMix64): el valor i depende sólo de la
+// semilla y de i, así que cada hilo rellena su rango de forma independiente
+// y el resultado no cambia con el número de hilos.
+inline std::uint64_t splitMix64(std::uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+inline double generatedValue(std::uint64_t seed, std::size_t i) {
+    std::uint64_t r = splitMix64(seed ^ splitMix64(i));
+    double u = (r >> 11) * (1.0 / 9007199254740992.0); // [0, 1) con 53 bits
+    return std::round(u * 100);
+}
+
+// Rellena out[start, end) con los valores generados para seed
+// out[i] recibe el valor de índice global first + i
+inline void fillGenerated(Element* out, std::uint64_t seed, std::size_t start, std::size_t end,
+                          std::size_t first = 0) {
+    for (std::size_t i = start; i < end; ++i) {
+        out[i] = static_cast<Element>(generatedValue(seed, first + i));
+    }
+}
+
+// Datos generados en paralelo; la memoria se reserva sin inicializar para
+// que cada hilo sea el primero en tocar las páginas de su rango. Los
+// conjuntos grandes se alinean a página enorme y se piden al núcleo con
+// MADV_HUGEPAGE, para que coincidan con las fronteras de chunkBoundary.
+class GeneratedData {
+    struct FreeValues {
+        void operator()(Element* p) const { std::free(p); }
+    };
+
+    std::unique_ptr<Element[], FreeValues> values;
+    std::size_t count = 0;
+
+public:
+    // Reserva n valores sin inicializar; quien los escriba primero decide su nodo
+    Element* allocate(std::size_t n) {
+        std::size_t bytes = std::max<std::size_t>(n, 1) * sizeof(Element);
+        bool huge = bytes >= HUGE_PAGE_BYTES;
+        std::size_t align = huge ? HUGE_PAGE_BYTES : CACHE_LINE_BYTES;
+        bytes = (bytes + align - 1) / align * align;
+        void* p = nullptr;
+        if (posix_memalign(&p, align, bytes) != 0) {
+            throw std::bad_alloc();
+        }
+#ifdef MADV_HUGEPAGE
+        if (huge) {
+            madvise(p, bytes, MADV_HUGEPAGE); // sólo una sugerencia; si falla quedan páginas normales
+        }
+#endif
+        values.reset(static_cast<Element*>(p));
+        count = n;
+        return values.get();
+    }
+
+    // Valores de índice global [first, first + n): un proceso del modo MPI
+    // genera sólo su parte y obtiene los mismos datos que uno solo con todo
+    void generate(std::size_t n, std::uint64_t seed, std::size_t first = 0) {
+        Element* out = allocate(n);
+        int num_threads = std::max(1u, std::thread::hardware_concurrency());
+        std::size_t min_per_thread = 1 << 16;
+        num_threads = static_cast<int>(std::min<std::size_t>(num_threads, n / min_per_thread + 1));
+
+        auto fill = [out, n, seed, first, num_threads](int t) {
+            fillGenerated(out, seed, n * t / num_threads, n * (t + 1) / num_threads, first);
+        };
+
+        std::vector<std::thread> threads;
+        for (int t = 1; t < num_threads; ++t) {
+            threads.emplace_back(fill, t);
+        }
+        fill(0);
+        for (auto& th : threads) {
+            th.join();
+        }
+    }
+
+    // Los 100 valores de siempre (std::rand con semilla 42)
+    void legacy() {
+        allocate(100);
+        std::srand(42);
+        for (std::size_t i = 0; i < count; ++i) {
+            values[i] = static_cast<Element>(std::round((std::rand() / (double)RAND_MAX) * 100));
+        }
+    }
+
+    DataSpan<Element> span() const {
+        DataSpan<Element> s;
+        s.ptr = values.get();
+        s.count = count;
+        return s;
+    }
+};
+
+// Prepara los datos según las opciones: un fichero proyectado, n valores
+// generados con la semilla dada o, si n es 0, los 100 valores de siempre.
+inline bool loadDataset(const std::string& file, std::size_t n, std::uint64_t seed,
+                        GeneratedData& generated, MappedFile& mapped, DataSpan<Element>& data) {
+    if (!file.empty()) {
+        if (!mapped.open(file)) {
+            return false;
+        }
+        data = mapped.span();
+    } else {
+        if (n > 0) {
+            generated.generate(n, seed);
+        } else {
+            generated.legacy();
+        }
+        data = generated.span();
+    }
+    return true;
+}
+
+#endif // DATASET_H
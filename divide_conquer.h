@@ -0,0 +1,86 @@
+#ifndef DIVIDE_CONQUER_H
+#define DIVIDE_CONQUER_H
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include "chunking.h"
+#include "dataset.h"
+#include "stats_task.h"
+#include "trace.h"
+#include "worker_pool.h"
+
+// Tamaño de rango por debajo del cual no compensa seguir dividiendo
+const int DEFAULT_GRAIN = 2048;
+
+// Hilos del pool para una profundidad dada: nunca más que núcleos, contando
+// con que el hilo llamante también ejecuta una mitad en cada división.
+inline int divideConquerThreads(int splits) {
+    int cores = std::max(1u, std::thread::hardware_concurrency());
+    long long leaves = 1LL << std::min(splits, 32);
+    return static_cast<int>(std::min<long long>(leaves, cores)) - 1;
+}
+
+// Divide [start, end) en mitades mientras quede profundidad y el rango supere
+// el grano: la mitad derecha se delega al pool y la izquierda se ejecuta en
+// línea. El punto medio se alinea a línea de caché; si el rango no da para
+// dos líneas no se divide. La combinación sigue la forma del árbol, así que
+// es determinista. El estado de la mitad derecha vive en la pila y la tarea
+// sólo captura un puntero, así que std::function no reserva memoria.
+template <typename Acc, typename T>
+StatsPartial<Acc> splitRange(WorkerPool& pool, DataSpan<T> data, std::size_t start,
+                             std::size_t end, int depth, std::size_t grain) {
+    std::size_t mid = start + chunkBoundary(data.ptr + start, end - start, 2, 1);
+    if (depth == 0 || end - start <= grain || mid == start) {
+        StatsPartial<Acc> result;
+        StatsTask<T, Acc>(data, start, end, result).computeMetrics();
+        return result;
+    }
+
+    struct Fork {
+        WorkerPool& pool;
+        DataSpan<T> data;
+        std::size_t start, end;
+        int depth;
+        std::size_t grain;
+        long long trace_id;
+        StatsPartial<Acc> result;
+        std::atomic<bool> done;
+    } right{pool, data, mid, end, depth - 1, grain, traceNextId(), {}, {false}};
+    traceEnqueue(right.trace_id);
+    Fork* fork = &right;
+    pool.submit([fork] {
+        traceDequeue(fork->trace_id);
+        fork->result = splitRange<Acc>(fork->pool, fork->data, fork->start, fork->end, fork->depth, fork->grain);
+        fork->done.store(true, std::memory_order_release);
+    });
+
+    StatsPartial<Acc> left = splitRange<Acc>(pool, data, start, mid, depth - 1, grain);
+    pool.helpUntil(right.done);
+    left.merge(right.result);
+    return left;
+}
+
+// Divide and Conquer strategy: fork/join recursivo sobre el pool persistente
+template <typename Acc, typename T>
+void divideAndConquer(WorkerPool& pool, DataSpan<T> data, int splits,
+                      std::size_t grain, double& mode, double& stddev, ProductValue& sum) {
+    if (data.empty()) {
+        mode = 0;
+        stddev = 0;
+        sum = ProductValue();
+        return;
+    }
+
+    if (splits < 0 || splits > 32) {
+        std::cerr << "Error: -d VALOR debe estar entre 0 y 32\n";
+        return;
+    }
+
+    StatsPartial<Acc> total = splitRange<Acc>(pool, data, 0, data.size(), splits,
+                                              std::max<std::size_t>(grain, 1));
+    finalizeStats(total, mode, stddev, sum);
+}
+
+#endif // DIVIDE_CONQUER_H
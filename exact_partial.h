@@ -0,0 +1,106 @@
+#ifndef EXACT_PARTIAL_H
+#define EXACT_PARTIAL_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "histogram.h"
+#include "stats_kernel.h"
+#include "stats_partial.h"
+
+// Media y M2 de Welford, combinables entre trozos (Chan et al.)
+struct WelfordMoments {
+    long long count = 0;
+    double mean = 0;
+    double m2 = 0; // suma de cuadrados de las desviaciones a la media
+
+    void add(double v) {
+        ++count;
+        double delta = v - mean;
+        mean += delta / count;
+        m2 += delta * (v - mean);
+    }
+
+    void merge(const WelfordMoments& other) {
+        if (other.count == 0) {
+            return;
+        }
+        long long n = count + other.count;
+        double delta = other.mean - mean;
+        mean += delta * other.count / n;
+        m2 += other.m2 + delta * delta * (static_cast<double>(count) * other.count / n);
+        count = n;
+    }
+};
+
+// Estadísticas exactas de un trozo: los momentos para la varianza y un
+// histograma privado para la moda (ver histogram.h). La suma exacta es la
+// suma Σx que ya acumula StatsPartial con su política Acc.
+template <typename T>
+struct ExactPartial {
+    WelfordMoments moments;
+    ValueHistogram<T> histogram;
+};
+
+// Reducción en árbol por pares de los momentos, en el mismo orden que
+// reducePartials; los histogramas se combinan aparte con histogramMode
+template <typename T>
+WelfordMoments reduceMoments(const std::vector<ExactPartial<T>>& partials) {
+    std::vector<WelfordMoments> moments;
+    moments.reserve(partials.size());
+    for (const ExactPartial<T>& p : partials) {
+        moments.push_back(p.moments);
+    }
+    std::size_t n = moments.size();
+    for (std::size_t step = 1; step < n; step *= 2) {
+        for (std::size_t i = 0; i + step < n; i += 2 * step) {
+            moments[i].merge(moments[i + step]);
+        }
+    }
+    return n > 0 ? moments[0] : WelfordMoments();
+}
+
+// Elementos por bloque: el núcleo vectorial y el recuento exacto recorren el
+// mismo bloque seguido, así que cada dato se lee de memoria una sola vez
+const std::size_t EXACT_BLOCK = 4096;
+
+template <typename T, typename Acc>
+void runExactKernel(const T* data, std::size_t start, std::size_t end, long long base,
+                    StatsPartial<Acc>& out, ExactPartial<T>& exact) {
+    long long begin = metricsNow();
+    StatsPartial<Acc> local;
+    for (std::size_t b = start; b < end; b += EXACT_BLOCK) {
+        std::size_t e = std::min(end, b + EXACT_BLOCK);
+        StatsPartial<Acc> block;
+        dispatchStatsKernel(data, b, e, base, block);
+        local.merge(block);
+        for (std::size_t i = b; i < e; ++i) {
+            exact.moments.add(static_cast<double>(data[i]));
+        }
+        exact.histogram.addRange(data + b, e - b);
+    }
+    out = local;
+    metricsKernel(begin, end - start); // un único trozo, no uno por bloque
+}
+
+struct ExactStats {
+    double mode = 0;          // valor más frecuente (el menor si hay empate)
+    long long mode_count = 0;
+    double mean = 0;
+    double stddev = 0;        // muestral, con n - 1
+    double sum = 0;
+};
+
+template <typename Acc>
+void finalizeExact(const WelfordMoments& moments, const StatsPartial<Acc>& total, const HistogramMode& mode,
+                   ExactStats& out) {
+    out.mode = mode.value;
+    out.mode_count = mode.count;
+    out.sum = total.sum.value();
+    out.mean = moments.mean;
+    out.stddev = moments.count > 1 ? std::sqrt(moments.m2 / (moments.count - 1)) : 0.0;
+}
+
+#endif // EXACT_PARTIAL_H
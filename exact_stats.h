@@ -0,0 +1,58 @@
+#ifndef EXACT_STATS_H
+#define EXACT_STATS_H
+
+#include <cstddef>
+#include <vector>
+#include "chunking.h"
+#include "dataset.h"
+#include "exact_partial.h"
+#include "histogram.h"
+#include "stats_partial.h"
+#include "stats_task.h"
+
+// Exact strategy: los trozos habituales (ver chunking.h) calculan a la vez
+// las métricas de siempre y las exactas, cada uno con sus parciales y su
+// histograma privado; después la moda se combina en paralelo. submit encola
+// una std::function<void()> en el pool que se quiera (poolSubmitter para un
+// WorkerPool, QThreadPool::start) y workers cuenta también al llamante.
+template <typename Acc, typename T, typename Submit>
+void exactStats(Submit submit, int workers, DataSpan<T> data, double& mode, double& stddev, ProductValue& sum,
+                ExactStats& exact) {
+    exact = ExactStats();
+    if (data.empty()) {
+        mode = 0;
+        stddev = 0;
+        sum = ProductValue();
+        return;
+    }
+
+    std::size_t size = data.size();
+    int chunks = static_cast<int>(chunkCount(size, workers));
+    std::vector<StatsPartial<Acc>> partials(chunks);
+    std::vector<ExactPartial<T>> exacts(chunks);
+    int parts = histogramParts(workers); // tablas hash de cada histograma, ver histogramMode
+    std::vector<StatsTask<T, Acc>> tasks;
+    tasks.reserve(chunks);
+    for (int i = 0; i < chunks; ++i) {
+        std::size_t start = chunkBoundary(data.ptr, size, chunks, i);
+        std::size_t end = chunkBoundary(data.ptr, size, chunks, i + 1);
+        tasks.emplace_back(data, start, end, partials[i]);
+        exacts[i].histogram.setParts(parts);
+        tasks.back().collectExact(exacts[i]);
+        tasks.back().markEnqueued();
+    }
+    auto compute = [&tasks](int i) { tasks[i].computeMetrics(); };
+    runParts(submit, chunks, compute);
+
+    std::vector<const ValueHistogram<T>*> histograms;
+    for (const ExactPartial<T>& e : exacts) {
+        histograms.push_back(&e.histogram);
+    }
+    HistogramMode best = histogramMode(histograms, submit);
+
+    StatsPartial<Acc> total = reducePartials(partials);
+    finalizeStats(total, mode, stddev, sum);
+    finalizeExact(reduceMoments(exacts), total, best, exact);
+}
+
+#endif // EXACT_STATS_H
@@ -0,0 +1,182 @@
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <cuda_runtime.h>
+#include "gpu_stats.h"
+
+// Reducción de StatsTask en CUDA (ver gpu_stats.h). Cada hilo recorre con
+// paso de rejilla su parte del segmento igual que statsKernelScalar y el
+// bloque combina los parciales de sus hilos en árbol en memoria compartida.
+// La rejilla es fija para cada tamaño, así que el resultado es reproducible.
+// Todas las sumas del bloque son double sin compensar, como PlainAccumulator.
+
+static bool cudaCheck(cudaError_t err, const char* what) {
+    if (err != cudaSuccess) {
+        std::cerr << "Error: CUDA " << what << ": " << cudaGetErrorString(err) << "\n";
+        return false;
+    }
+    return true;
+}
+
+template <typename T>
+__global__ void statsBlockKernel(const T* data, std::size_t n, long long base, GpuPartial* out) {
+    __shared__ double s_log[GPU_BLOCK_THREADS];
+    __shared__ double s_sum[GPU_BLOCK_THREADS];
+    __shared__ double s_diff[GPU_BLOCK_THREADS];
+    __shared__ long long s_count[GPU_BLOCK_THREADS];
+    __shared__ int s_zero[GPU_BLOCK_THREADS];
+    __shared__ int s_neg[GPU_BLOCK_THREADS];
+
+    double log_sum = 0, sum = 0, diff_sum = 0;
+    long long count = 0;
+    int has_zero = 0, negative = 0;
+    std::size_t stride = static_cast<std::size_t>(blockDim.x) * gridDim.x;
+    for (std::size_t i = static_cast<std::size_t>(blockIdx.x) * blockDim.x + threadIdx.x; i < n; i += stride) {
+        double val = static_cast<double>(data[i]);
+        if (val == 0) {
+            has_zero = 1;
+        } else {
+            log_sum += log(fabs(val));
+        }
+        negative ^= (val < 0);
+        sum += val;
+        diff_sum += val - static_cast<double>(base + static_cast<long long>(i)); // Moda: data[i] - i
+        ++count;
+    }
+
+    int t = threadIdx.x;
+    s_log[t] = log_sum;
+    s_sum[t] = sum;
+    s_diff[t] = diff_sum;
+    s_count[t] = count;
+    s_zero[t] = has_zero;
+    s_neg[t] = negative;
+    __syncthreads();
+    for (int step = blockDim.x / 2; step > 0; step >>= 1) {
+        if (t < step) {
+            s_log[t] += s_log[t + step];
+            s_sum[t] += s_sum[t + step];
+            s_diff[t] += s_diff[t + step];
+            s_count[t] += s_count[t + step];
+            s_zero[t] |= s_zero[t + step];
+            s_neg[t] ^= s_neg[t + step];
+        }
+        __syncthreads();
+    }
+    if (t == 0) {
+        GpuPartial p;
+        p.log_sum = s_log[0];
+        p.sum = s_sum[0];
+        p.diff_sum = s_diff[0];
+        p.count = s_count[0];
+        p.has_zero = s_zero[0];
+        p.negative = s_neg[0];
+        out[blockIdx.x] = p;
+    }
+}
+
+// Recursos de uno de los dos streams: un buffer de paso en memoria fijada
+// (cudaMemcpyAsync sólo es asíncrono desde ella), el segmento en la GPU y
+// los parciales de sus bloques
+template <typename T>
+struct GpuLane {
+    cudaStream_t stream = nullptr;
+    T* staging = nullptr;
+    T* device = nullptr;
+    GpuPartial* device_partials = nullptr;
+    GpuPartial* host_partials = nullptr;
+    int blocks = 0;
+    bool busy = false;
+
+    bool init() {
+        return cudaCheck(cudaStreamCreate(&stream), "cudaStreamCreate") &&
+               cudaCheck(cudaMallocHost(&staging, GPU_SEGMENT_ELEMS * sizeof(T)), "cudaMallocHost") &&
+               cudaCheck(cudaMalloc(&device, GPU_SEGMENT_ELEMS * sizeof(T)), "cudaMalloc") &&
+               cudaCheck(cudaMalloc(&device_partials, GPU_SEGMENT_BLOCKS * sizeof(GpuPartial)), "cudaMalloc") &&
+               cudaCheck(cudaMallocHost(&host_partials, GPU_SEGMENT_BLOCKS * sizeof(GpuPartial)), "cudaMallocHost");
+    }
+
+    // Espera el segmento en curso y entrega sus parciales
+    bool drain(GpuSegmentSink sink, void* context) {
+        if (!busy) {
+            return true;
+        }
+        busy = false;
+        if (!cudaCheck(cudaStreamSynchronize(stream), "cudaStreamSynchronize")) {
+            return false;
+        }
+        sink(host_partials, blocks, context);
+        return true;
+    }
+};
+
+// Los buffers se reservan con la primera llamada y se conservan: reservar
+// memoria fijada cuesta milisegundos, más que reducir un segmento
+template <typename T>
+static bool gpuReduceSegments(const T* data, std::size_t n, long long base, GpuSegmentSink sink, void* context) {
+    static GpuLane<T> lanes[2];
+    static bool ready = lanes[0].init() && lanes[1].init();
+    if (!ready) {
+        return false;
+    }
+
+    std::size_t segment = std::min(GPU_SEGMENT_ELEMS, std::max(GPU_MIN_SEGMENT_ELEMS, (n + 3) / 4));
+    std::size_t segments = (n + segment - 1) / segment;
+    for (std::size_t s = 0; s < segments; ++s) {
+        GpuLane<T>& lane = lanes[s % 2];
+        if (!lane.drain(sink, context)) {
+            return false;
+        }
+        // Mientras se copia este segmento al buffer de paso, la GPU sigue
+        // con el anterior en el otro stream
+        std::size_t begin = s * segment;
+        std::size_t count = std::min(segment, n - begin);
+        std::memcpy(lane.staging, data + begin, count * sizeof(T));
+        if (!cudaCheck(cudaMemcpyAsync(lane.device, lane.staging, count * sizeof(T), cudaMemcpyHostToDevice,
+                                       lane.stream), "cudaMemcpyAsync")) {
+            return false;
+        }
+        std::size_t needed = (count + GPU_BLOCK_THREADS - 1) / GPU_BLOCK_THREADS;
+        lane.blocks = static_cast<int>(std::min<std::size_t>(GPU_SEGMENT_BLOCKS, needed));
+        statsBlockKernel<T><<<lane.blocks, GPU_BLOCK_THREADS, 0, lane.stream>>>(
+            lane.device, count, base + static_cast<long long>(begin), lane.device_partials);
+        if (!cudaCheck(cudaGetLastError(), "statsBlockKernel") ||
+            !cudaCheck(cudaMemcpyAsync(lane.host_partials, lane.device_partials, lane.blocks * sizeof(GpuPartial),
+                                       cudaMemcpyDeviceToHost, lane.stream), "cudaMemcpyAsync")) {
+            return false;
+        }
+        lane.busy = true;
+    }
+    // Los parciales se entregan en el orden de los segmentos
+    return lanes[segments % 2].drain(sink, context) && lanes[(segments + 1) % 2].drain(sink, context);
+}
+
+const char* gpuDeviceName() {
+    static char name[256] = "";
+    int devices = 0;
+    if (cudaGetDeviceCount(&devices) != cudaSuccess || devices == 0) {
+        return nullptr;
+    }
+    cudaDeviceProp prop;
+    if (cudaGetDeviceProperties(&prop, 0) != cudaSuccess) {
+        return nullptr;
+    }
+    std::strncpy(name, prop.name, sizeof(name) - 1);
+    return name;
+}
+
+bool gpuReduce(const double* data, std::size_t n, long long base, GpuSegmentSink sink, void* context) {
+    return gpuReduceSegments(data, n, base, sink, context);
+}
+
+bool gpuReduce(const float* data, std::size_t n, long long base, GpuSegmentSink sink, void* context) {
+    return gpuReduceSegments(data, n, base, sink, context);
+}
+
+bool gpuReduce(const std::int32_t* data, std::size_t n, long long base, GpuSegmentSink sink, void* context) {
+    return gpuReduceSegments(data, n, base, sink, context);
+}
+
+bool gpuReduce(const std::int64_t* data, std::size_t n, long long base, GpuSegmentSink sink, void* context) {
+    return gpuReduceSegments(data, n, base, sink, context);
+}
@@ -0,0 +1,117 @@
+#ifndef GPU_STATS_H
+#define GPU_STATS_H
+
+#ifdef STATS_WITH_CUDA
+
+#include <cstddef>
+#include <cstdint>
+
+// Descarga en GPU (qmake CONFIG+=cuda, ver gpu_stats.cu): la misma reducción
+// que computeMetrics, por bloques. Los datos se copian por segmentos a la
+// GPU con dos streams, de modo que la copia de un segmento se solapa con el
+// núcleo del anterior; cada bloque de CUDA devuelve su parcial y el
+// anfitrión los combina con la política Acc.
+//
+// Precisión: dentro de cada bloque las sumas son double sin compensar (la
+// de cada hilo y el árbol en memoria compartida), así que la política Acc
+// sólo rige al combinar los parciales de los bloques. Eso equivale a
+// PlainAccumulator; con Kahan o LongDouble se perderían sus garantías, y
+// gpuSupports<Acc>() lo rechaza.
+
+// Parcial de un bloque de CUDA, en tipos que la GPU sabe sumar
+struct GpuPartial {
+    double log_sum;
+    double sum;
+    double diff_sum;
+    long long count;
+    int has_zero;
+    int negative;
+};
+
+// Con menos elementos la copia a la GPU cuesta más que el cálculo en CPU
+const std::size_t GPU_MIN_ELEMS = std::size_t(1) << 24;
+
+// Hilos por bloque y bloques por segmento; a la vez, número de parciales
+// que devuelve cada segmento
+const int GPU_BLOCK_THREADS = 256;
+const int GPU_SEGMENT_BLOCKS = 1024;
+
+// Elementos que se copian a la GPU de una vez, como mucho. Una entrada más
+// corta (un buffer de -S) se parte en cuatro segmentos de al menos
+// GPU_MIN_SEGMENT_ELEMS para que los dos streams sigan solapándose.
+const std::size_t GPU_SEGMENT_ELEMS = std::size_t(1) << 22;
+const std::size_t GPU_MIN_SEGMENT_ELEMS = std::size_t(1) << 16;
+
+// Nombre de la primera GPU o nullptr si no hay ninguna utilizable
+const char* gpuDeviceName();
+
+// Reduce data[0, n), cuyo primer elemento tiene índice global base. Llama a
+// sink(partials, count, context) en el anfitrión con los parciales de cada
+// segmento, en orden. Devuelve false, con el error en std::cerr, si CUDA falla.
+// Hay una sobrecarga por cada STATS_ELEMENT admitido (ver stats_types.h).
+typedef void (*GpuSegmentSink)(const GpuPartial* partials, int count, void* context);
+bool gpuReduce(const double* data, std::size_t n, long long base, GpuSegmentSink sink, void* context);
+bool gpuReduce(const float* data, std::size_t n, long long base, GpuSegmentSink sink, void* context);
+bool gpuReduce(const std::int32_t* data, std::size_t n, long long base, GpuSegmentSink sink, void* context);
+bool gpuReduce(const std::int64_t* data, std::size_t n, long long base, GpuSegmentSink sink, void* context);
+
+#ifndef __CUDACC__
+#include <type_traits>
+#include "accumulator.h"
+#include "dataset.h"
+#include "stats_partial.h"
+#include "stream_stats.h"
+
+// Políticas que el núcleo de CUDA implementa tal cual (ver arriba)
+template <typename Acc>
+constexpr bool gpuSupports() {
+    return std::is_same<Acc, PlainAccumulator>::value;
+}
+
+template <typename Acc>
+void gpuMergePartials(const GpuPartial* partials, int count, void* context) {
+    StatsPartial<Acc>& total = *static_cast<StatsPartial<Acc>*>(context);
+    for (int b = 0; b < count; ++b) {
+        const GpuPartial& p = partials[b];
+        StatsPartial<Acc> block;
+        block.log_sum.add(p.log_sum);
+        block.sum.add(p.sum);
+        block.diff_sum.add(p.diff_sum);
+        block.count = p.count;
+        block.has_zero = p.has_zero != 0;
+        block.negative = p.negative != 0;
+        total.merge(block);
+    }
+}
+
+// GPU strategy: misma interfaz que el resto; false si CUDA falla
+template <typename Acc, typename T>
+bool gpuStats(DataSpan<T> data, double& mode, double& stddev, ProductValue& sum) {
+    if (data.empty()) {
+        mode = 0;
+        stddev = 0;
+        sum = ProductValue();
+        return true;
+    }
+    StatsPartial<Acc> total;
+    if (!gpuReduce(data.ptr, data.size(), 0, &gpuMergePartials<Acc>, &total)) {
+        return false;
+    }
+    finalizeStats(total, mode, stddev, sum);
+    return true;
+}
+
+// -S con --gpu: cada buffer del lector pasa por gpuReduce con su índice
+// global, de modo que la lectura del siguiente buffer se solapa con la copia
+// y el cálculo del actual
+template <typename T, typename Acc>
+bool gpuStreamStats(int fd, std::size_t buffer_elems, StatsPartial<Acc>& total) {
+    return streamBuffers<T>(fd, buffer_elems, total, [](DataSpan<T> span, long long offset, StatsPartial<Acc>& acc) {
+        return gpuReduce(span.ptr, span.size(), offset, &gpuMergePartials<Acc>, &acc);
+    });
+}
+#endif // __CUDACC__
+
+#endif // STATS_WITH_CUDA
+
+#endif // GPU_STATS_H
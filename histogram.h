@@ -0,0 +1,164 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "latch.h"
+
+// Histograma de valores para la moda. Cada trozo rellena el suyo, privado,
+// sin cerrojos; al final se combinan en paralelo. Los enteros de [0,
+// DENSE_BINS) —el dominio de los datos generados— van a contadores densos,
+// el resto a tablas hash, una por parte de la combinación (hash % parts), para
+// que cada parte recorra sólo sus claves. Los contadores densos tienen DENSE_LANES copias
+// que se reparten elementos consecutivos, de modo que incrementos seguidos
+// del mismo valor no se encadenan, y se suman con bucles vectorizables.
+const int DENSE_BINS = 1024;
+const int DENSE_LANES = 4;
+
+// Partes de la combinación para workers hilos: como mucho una por bin denso
+inline int histogramParts(int workers) {
+    return std::max(1, std::min(workers, DENSE_BINS));
+}
+
+struct alignas(64) DenseBins {
+    long long lanes[DENSE_LANES][DENSE_BINS];
+};
+
+template <typename T>
+class ValueHistogram {
+    std::unique_ptr<DenseBins> dense; // se reserva con el primer valor denso
+    std::vector<std::unordered_map<T, long long>> sparse; // una tabla por parte
+    std::hash<T> hasher;
+
+    static bool denseIndex(T x, int& bin) {
+        double v = static_cast<double>(x);
+        if (v >= 0 && v < DENSE_BINS && v == std::floor(v)) {
+            bin = static_cast<int>(v);
+            return true;
+        }
+        return false;
+    }
+
+    void addOne(T x, int lane) {
+        int bin;
+        if (denseIndex(x, bin)) {
+            if (!dense) {
+                dense.reset(new DenseBins());
+            }
+            ++dense->lanes[lane][bin];
+        } else if (x == x) { // los NaN no cuentan
+            ++sparse[sparse.size() == 1 ? 0 : hasher(x) % sparse.size()][x];
+        }
+    }
+
+public:
+    explicit ValueHistogram(int parts = 1) : sparse(std::max(1, parts)) {}
+
+    // Cambia el número de partes; sólo antes de añadir valores
+    void setParts(int parts) { sparse.assign(std::max(1, parts), std::unordered_map<T, long long>()); }
+
+    int parts() const { return static_cast<int>(sparse.size()); }
+
+    void addRange(const T* data, std::size_t n) {
+        std::size_t i = 0;
+        for (; i + DENSE_LANES <= n; i += DENSE_LANES) {
+            for (int l = 0; l < DENSE_LANES; ++l) {
+                addOne(data[i + l], l);
+            }
+        }
+        for (; i < n; ++i) {
+            addOne(data[i], 0);
+        }
+    }
+
+    const DenseBins* denseBins() const { return dense.get(); }
+    const std::unordered_map<T, long long>& sparseCounts(int part) const { return sparse[part]; }
+};
+
+// Valor más frecuente; con empate gana el menor
+struct HistogramMode {
+    double value = 0;
+    long long count = 0;
+
+    void offer(double v, long long c) {
+        if (c > count || (c == count && c > 0 && v < value)) {
+            value = v;
+            count = c;
+        }
+    }
+};
+
+// Ejecuta f(0) ... f(parts - 1): f(0) en el hilo llamante y el resto con
+// submit, que encola una std::function<void()> en cualquier pool (WorkerPool
+// o QThreadPool); espera a que terminen todas con un CompletionLatch
+template <typename Submit, typename F>
+void runParts(Submit& submit, int parts, F& f) {
+    CompletionLatch remaining(parts - 1);
+    for (int i = 1; i < parts; ++i) {
+        submit([&f, &remaining, i] {
+            f(i);
+            remaining.countDown();
+        });
+    }
+    f(0);
+    remaining.wait();
+}
+
+// Moda de la unión de los histogramas sin combinarlos: la parte k suma los
+// contadores densos de su rango de bins y la tabla k de todos los
+// histogramas, y elige su máximo; luego se comparan los parts máximos. Todos
+// los histogramas tienen que haberse creado con el mismo número de partes.
+template <typename T, typename Submit>
+HistogramMode histogramMode(const std::vector<const ValueHistogram<T>*>& histograms, Submit submit) {
+    if (histograms.empty()) {
+        return HistogramMode();
+    }
+    int parts = histograms[0]->parts();
+    std::vector<HistogramMode> best(parts);
+
+    auto part = [&](int k) {
+        HistogramMode local;
+        int first = DENSE_BINS * k / parts;
+        int last = DENSE_BINS * (k + 1) / parts;
+        std::vector<long long> totals(last - first, 0);
+        for (const ValueHistogram<T>* h : histograms) {
+            const DenseBins* d = h->denseBins();
+            if (!d) {
+                continue;
+            }
+            for (int l = 0; l < DENSE_LANES; ++l) {
+                for (int b = first; b < last; ++b) {
+                    totals[b - first] += d->lanes[l][b];
+                }
+            }
+        }
+        for (int b = first; b < last; ++b) {
+            local.offer(b, totals[b - first]);
+        }
+
+        std::unordered_map<T, long long> mine;
+        for (const ValueHistogram<T>* h : histograms) {
+            for (const auto& kv : h->sparseCounts(k)) {
+                mine[kv.first] += kv.second;
+            }
+        }
+        for (const auto& kv : mine) {
+            local.offer(static_cast<double>(kv.first), kv.second);
+        }
+        best[k] = local;
+    };
+    runParts(submit, parts, part);
+
+    HistogramMode mode;
+    for (const HistogramMode& m : best) {
+        mode.offer(m.value, m.count);
+    }
+    return mode;
+}
+
+#endif // HISTOGRAM_H
@@ -0,0 +1,90 @@
+#ifndef LATCH_H
+#define LATCH_H
+
+#include <atomic>
+#include <climits>
+#include <thread>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Pausa de espera activa: alivia al hermano SMT y al bus mientras se gira
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+// Vueltas de espera activa antes de dormir: unos microsegundos, lo que tarda
+// en terminar un trozo pequeño, frente a las decenas que cuesta despertar
+// un hilo dormido a través del núcleo
+const int LATCH_SPINS = 4096;
+
+// Cuenta atrás de fin de trabajo. wait() gira un tiempo acotado y después se
+// duerme en un futex sobre el propio contador; el bit WAITING avisa a
+// countDown() de que tiene que despertarlo. El último countDown() sólo toca
+// el contador con la operación atómica, así que quien espera puede destruir
+// el latch en cuanto wait() vuelve (el futex_wake sólo usa la dirección).
+class CompletionLatch {
+    static const int WAITING = 1 << 30;
+    std::atomic<int> state;
+
+#ifdef __linux__
+    void park(int expected) {
+        syscall(SYS_futex, reinterpret_cast<int*>(&state), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+    }
+
+    void wakeAll() {
+        syscall(SYS_futex, reinterpret_cast<int*>(&state), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+    }
+#else
+    void park(int) { std::this_thread::yield(); }
+    void wakeAll() {}
+#endif
+
+public:
+    explicit CompletionLatch(int count = 0) : state(count) {}
+
+    CompletionLatch(const CompletionLatch&) = delete;
+    CompletionLatch& operator=(const CompletionLatch&) = delete;
+
+    // Rearma el latch; nadie puede estar esperándolo ni contando
+    void reset(int count) { state.store(count, std::memory_order_relaxed); }
+
+    void countDown() {
+        int before = state.fetch_sub(1, std::memory_order_acq_rel);
+        if (before == (WAITING | 1)) {
+            wakeAll();
+        }
+    }
+
+    bool done() const { return (state.load(std::memory_order_acquire) & ~WAITING) == 0; }
+
+    void wait() {
+        // Con una sola CPU girar sólo retrasa a los hilos que hay que esperar
+        static const int spins = std::thread::hardware_concurrency() > 1 ? LATCH_SPINS : 0;
+        for (int i = 0; i < spins; ++i) {
+            if (done()) {
+                return;
+            }
+            cpuRelax();
+        }
+        for (;;) {
+            int current = state.load(std::memory_order_acquire);
+            if ((current & ~WAITING) == 0) {
+                return;
+            }
+            if (!(current & WAITING) &&
+                !state.compare_exchange_weak(current, current | WAITING, std::memory_order_acq_rel)) {
+                continue;
+            }
+            park(current | WAITING);
+        }
+    }
+};
+
+#endif // LATCH_H
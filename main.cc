@@ -2,164 +2,472 @@
 #include <vector>
 #include <cmath>
 #include <thread>
-#include <mutex>
-#include <chrono>
 #include <getopt.h>
 #include <cstdlib>
 #include <fstream>
 #include <limits>
 #include <algorithm>
-
-// Clase para manejar las tareas estadísticas
-class StatsTask {
-    const std::vector<double>& data;
-    int start, end;
-    double& global_log_sum;
-    double& global_sum;
-    double& global_diff_sum;
-    std::mutex& mutex;
-    bool& has_zero;
-    int& global_count;
-
-public:
-    StatsTask(const std::vector<double>& d, int s, int e,
-              double& gls, double& gs, double& gds, std::mutex& mtx, bool& hz, int& gc)
-        : data(d), start(s), end(e),
-          global_log_sum(gls), global_sum(gs), global_diff_sum(gds),
-          mutex(mtx), has_zero(hz), global_count(gc) {}
-
-    void computeMetrics() {
-        double local_log_sum = 0.0;
-        double local_sum = 0.0;
-        double local_diff_sum = 0.0;
-        bool local_has_zero = false;
-        int local_count = 0;
-
-        for (int i = start; i < end; ++i) {
-            double val = data[i];
-            if (val == 0) {
-                local_has_zero = true;
-            } else {
-                local_log_sum += std::log(std::abs(val));
-            }
-            local_sum += val;
-            local_diff_sum += (val - i); // Moda: data[i] - i
-            local_count++;
-        }
-
-        std::lock_guard<std::mutex> lock(mutex);
-        global_log_sum += local_log_sum;
-        global_sum += local_sum;
-        global_diff_sum += local_diff_sum;
-        has_zero = has_zero || local_has_zero;
-        global_count += local_count;
-    }
-};
-
-// Divide and Conquer strategy
-void divideAndConquer(const std::vector<double>& data, int splits,
-                      double& mode, double& stddev, double& sum) {
-    if (data.empty()) {
-        mode = 0;
-        stddev = 0;
-        sum = 0;
-        return;
-    }
-
-    int size = data.size();
-    if (splits < 0 || splits > 32) {
-        std::cerr << "Error: -d VALOR debe estar entre 0 y 32\n";
-        return;
-    }
-
-    int parts = (splits == 0) ? 1 : (1 << splits);
-    double global_log_sum = 0.0, global_sum = 0.0, global_diff_sum = 0.0;
-    bool has_zero = false;
-    int global_count = 0;
-    std::mutex mutex;
-
-    int chunk_size = size / parts;
-    if (chunk_size == 0 || parts > 16) {
-        parts = std::min(size, 16);
-        chunk_size = size / parts;
-    }
-
-    std::vector<StatsTask> tasks;
-    std::vector<std::thread> threads;
-    tasks.reserve(parts);
-
-    for (int i = 0; i < parts; ++i) {
-        int start = i * chunk_size;
-        int end = (i == parts - 1) ? size : start + chunk_size;
-        tasks.emplace_back(data, start, end, global_log_sum, global_sum, global_diff_sum, mutex, has_zero, global_count);
-        if (parts == 1) {
-            tasks.back().computeMetrics();
-        } else {
-            threads.emplace_back(&StatsTask::computeMetrics, &tasks.back());
-        }
-    }
-
-    for (auto& t : threads) {
-        t.join();
-    }
-
-    mode = global_count > 0 ? global_diff_sum / global_count : 0.0; // Moda: promedio de diferencias
-    stddev = global_sum / 2.0; // Desviación estándar: suma total / 2
-    sum = has_zero ? 0 : std::exp(global_log_sum); // Sumatoria: producto
-}
+#include "affinity.h"
+#include "async_stats.h"
+#include "batch_stats.h"
+#include "benchmark.h"
+#include "coro_stats.h"
+#include "dataset.h"
+#include "divide_conquer.h"
+#include "exact_stats.h"
+#include "gpu_stats.h"
+#include "metrics.h"
+#include "numa.h"
+#include "sliding_stats.h"
+#include "stats_task.h"
+#include "stream_stats.h"
+#include "trace.h"
+#include "worker_pool.h"
 
 int main(int argc, char* argv[]) {
-    int opt, d_val = -1;
-    while ((opt = getopt(argc, argv, "d:")) != -1) {
+    static const option long_options[] = {
+        {"warmup", required_argument, nullptr, 'W'},
+        {"reps", required_argument, nullptr, 'R'},
+        {"pin", required_argument, nullptr, 'P'},
+        {"sweep", required_argument, nullptr, 'X'},
+        {"sizes", required_argument, nullptr, 'N'},
+        {"bench-out", required_argument, nullptr, 'O'},
+        {"trace", required_argument, nullptr, 'T'},
+        {"async", no_argument, nullptr, 'Y'},
+        {"coro", no_argument, nullptr, 'C'},
+        {"numa", no_argument, nullptr, 'M'},
+        {"batch", required_argument, nullptr, 'A'},
+        {"window", required_argument, nullptr, 'L'},
+        {"exact", no_argument, nullptr, 'E'},
+        {"prefetch", required_argument, nullptr, 'H'},
+        {"affinity", required_argument, nullptr, 'I'},
+        {"metrics", required_argument, nullptr, 'K'},
+        {"metrics-port", required_argument, nullptr, 'U'},
+        {"metrics-bind", required_argument, nullptr, 'V'},
+        {"gpu", no_argument, nullptr, 'G'},
+        {nullptr, 0, nullptr, 0}
+    };
+
+    int opt, d_val = -1, grain = DEFAULT_GRAIN;
+    std::string kernel = "auto", file;
+    std::size_t n_val = 0;
+    std::uint64_t seed = 42;
+    bool seed_set = false, stream = false, numa = false;
+    std::size_t buffer_elems = DEFAULT_STREAM_BUFFER;
+    std::size_t batch = 0, window = 0;
+    BenchOptions bench;
+    std::string trace_file, affinity_spec;
+    int metrics_interval = 0, metrics_port = -1;
+    std::string metrics_bind = DEFAULT_METRICS_BIND;
+    bool async = false, coro = false, exact = false, gpu = false;
+    std::vector<long long> list;
+    while ((opt = getopt_long(argc, argv, "d:g:k:n:s:f:SB:", long_options, nullptr)) != -1) {
         if (opt == 'd') {
             d_val = std::atoi(optarg);
             if (d_val < 0 || d_val > 32) {
                 std::cerr << "Error: -d VALOR debe estar entre 0 y 32\n";
                 return 1;
             }
+        } else if (opt == 'g') {
+            grain = std::atoi(optarg);
+            if (grain < 1) {
+                std::cerr << "Error: -g GRANO debe ser mayor que 0\n";
+                return 1;
+            }
+        } else if (opt == 'k') {
+            kernel = optarg;
+        } else if (opt == 'n') {
+            n_val = std::strtoull(optarg, nullptr, 10);
+            if (n_val == 0) {
+                std::cerr << "Error: -n VALOR debe ser mayor que 0\n";
+                return 1;
+            }
+        } else if (opt == 's') {
+            seed = std::strtoull(optarg, nullptr, 10);
+            seed_set = true;
+        } else if (opt == 'f') {
+            file = optarg;
+        } else if (opt == 'S') {
+            stream = true;
+        } else if (opt == 'B') {
+            buffer_elems = std::strtoull(optarg, nullptr, 10);
+            if (buffer_elems == 0) {
+                std::cerr << "Error: -B VALOR debe ser mayor que 0\n";
+                return 1;
+            }
+        } else if (opt == 'W') {
+            bench.warmup = std::atoi(optarg);
+            if (bench.warmup < 0) {
+                std::cerr << "Error: --warmup VALOR no puede ser negativo\n";
+                return 1;
+            }
+        } else if (opt == 'R') {
+            bench.repetitions = std::atoi(optarg);
+            if (bench.repetitions < 1) {
+                std::cerr << "Error: --reps VALOR debe ser mayor que 0\n";
+                return 1;
+            }
+        } else if (opt == 'P') {
+            bench.pin = optarg;
+        } else if (opt == 'X') {
+            if (!parseList(optarg, bench.sweep)) {
+                std::cerr << "Error: --sweep espera una lista como 0,1,2 o 0-4\n";
+                return 1;
+            }
+            for (long long v : bench.sweep) {
+                if (v < 0 || v > 32) {
+                    std::cerr << "Error: -d VALOR debe estar entre 0 y 32\n";
+                    return 1;
+                }
+            }
+        } else if (opt == 'N') {
+            if (!parseList(optarg, list)) {
+                std::cerr << "Error: --sizes espera una lista como 1000,1000000\n";
+                return 1;
+            }
+            for (long long v : list) {
+                if (v < 1) {
+                    std::cerr << "Error: -n VALOR debe ser mayor que 0\n";
+                    return 1;
+                }
+                bench.sizes.push_back(v);
+            }
+        } else if (opt == 'O') {
+            bench.output = optarg;
+        } else if (opt == 'M') {
+            numa = true;
+        } else if (opt == 'A') {
+            batch = std::strtoull(optarg, nullptr, 10);
+            if (batch == 0) {
+                std::cerr << "Error: --batch VALOR debe ser mayor que 0\n";
+                return 1;
+            }
+        } else if (opt == 'L') {
+            window = std::strtoull(optarg, nullptr, 10);
+            if (window == 0) {
+                std::cerr << "Error: --window VALOR debe ser mayor que 0\n";
+                return 1;
+            }
+        } else if (opt == 'Y') {
+            async = true;
+        } else if (opt == 'E') {
+            exact = true;
+        } else if (opt == 'G') {
+            gpu = true;
+#ifndef STATS_WITH_CUDA
+            std::cerr << "Error: --gpu requiere compilar con CUDA (qmake CONFIG+=cuda)\n";
+            return 1;
+#else
+            if (!gpuSupports<Accumulator>()) {
+                std::cerr << "Error: --gpu sólo admite STATS_ACCUMULATOR=PlainAccumulator, no "
+                          << Accumulator::name() << "\n";
+                return 1;
+            }
+#endif
+        } else if (opt == 'K' || opt == 'U') {
+            char* end = nullptr;
+            long value = std::strtol(optarg, &end, 10);
+            if (end == optarg || *end != '\0' || value < 0 || (opt == 'U' && value > 65535)) {
+                std::cerr << (opt == 'K' ? "Error: --metrics espera un periodo en segundos\n"
+                                         : "Error: --metrics-port espera un puerto entre 0 y 65535\n");
+                return 1;
+            }
+            (opt == 'K' ? metrics_interval : metrics_port) = static_cast<int>(value);
+        } else if (opt == 'V') {
+            metrics_bind = optarg;
+        } else if (opt == 'I') {
+            affinity_spec = optarg;
+        } else if (opt == 'H') {
+            char* end = nullptr;
+            stats_prefetch_bytes = std::strtoull(optarg, &end, 10);
+            if (end == optarg || *end != '\0') {
+                std::cerr << "Error: --prefetch espera una distancia en bytes (0 la desactiva)\n";
+                return 1;
+            }
+        } else if (opt == 'C') {
+            coro = true;
+#ifndef STATS_HAVE_COROUTINES
+            std::cerr << "Error: --coro requiere compilar con corrutinas de C++20 (qmake CONFIG+=coro)\n";
+            return 1;
+#endif
+        } else if (opt == 'T') {
+            trace_file = optarg;
+#ifndef STATS_TRACE
+            std::cerr << "Error: --trace requiere compilar con STATS_TRACE (qmake CONFIG+=trace)\n";
+            return 1;
+#endif
         } else {
-            std::cerr << "Error: opción inválida, use -d\n";
+            std::cerr << "Error: opción inválida, use -d [-g] [-k] [-n|-f] [-s] [-S [-B]]"
+                         " [--warmup] [--reps] [--pin] [--sweep] [--sizes] [--bench-out] [--trace] [--numa] [--batch] [--window] [--async] [--coro] [--exact] [--prefetch] [--affinity] [--metrics] [--metrics-port] [--metrics-bind] [--gpu]\n";
             return 1;
         }
     }
 
-    if (d_val == -1) {
+    if (d_val == -1 && bench.sweep.empty()) {
         std::cerr << "Error: debe especificar -d\n";
         return 1;
     }
 
-    std::vector<double> data(100);
-    std::srand(42);
-    for (int i = 0; i < 100; ++i) {
-        data[i] = std::round((std::rand() / (double)RAND_MAX) * 100);
+    if (!file.empty() && (n_val != 0 || !bench.sizes.empty())) {
+        std::cerr << "Error: no puede usar -f y -n juntos\n";
+        return 1;
+    }
+    if (seed_set && n_val == 0) {
+        n_val = 100;
+    }
+    if (bench.sweep.empty()) {
+        bench.sweep.push_back(d_val);
+    }
+    if (bench.sizes.empty()) {
+        bench.sizes.push_back(n_val);
     }
 
-    double mode = 0, stddev = 0, sum = 0;
-    const int RUNS = 5;
-    long min_duration = std::numeric_limits<long>::max();
-    std::string strategy = "DivideConquer";
+    // En modo flujo los datos se leen por buffers durante el cálculo
+    int stream_fd = -1;
+    if (numa && !affinity_spec.empty()) {
+        std::cerr << "Error: --numa ya fija cada worker a su nodo, no admite --affinity\n";
+        return 1;
+    }
+    if (stream && numa) {
+        std::cerr << "Error: --numa no se puede combinar con -S\n";
+        return 1;
+    }
+    if (batch > 0 && (stream || numa)) {
+        std::cerr << "Error: --batch no se puede combinar con -S ni --numa\n";
+        return 1;
+    }
+    if (window > 0 && (stream || numa || batch > 0)) {
+        std::cerr << "Error: --window no se puede combinar con -S, --numa ni --batch\n";
+        return 1;
+    }
+    if (async && (stream || numa || batch > 0 || window > 0)) {
+        std::cerr << "Error: --async sólo se combina con -d\n";
+        return 1;
+    }
+    if (coro && (stream || numa || batch > 0 || window > 0 || async)) {
+        std::cerr << "Error: --coro sólo se combina con -d\n";
+        return 1;
+    }
+    if (exact && (stream || numa || batch > 0 || window > 0 || async || coro)) {
+        std::cerr << "Error: --exact sólo se combina con -d\n";
+        return 1;
+    }
+    if (gpu && (numa || batch > 0 || window > 0 || async || coro || exact)) {
+        std::cerr << "Error: --gpu sólo se combina con -d y -S\n";
+        return 1;
+    }
+    if (stream) {
+        if (n_val != 0 || bench.sizes.size() > 1 || bench.sweep.size() > 1) {
+            std::cerr << "Error: -S lee de -f o de la entrada estándar, sin -n ni barridos\n";
+            return 1;
+        }
+        stream_fd = openStreamInput(file);
+        if (stream_fd < 0) {
+            return 1;
+        }
+        bench.warmup = 0;
+        bench.repetitions = 1; // un flujo sólo puede leerse una vez
+    }
 
-    for (int i = 0; i < RUNS; ++i) {
-        auto start = std::chrono::high_resolution_clock::now();
-        divideAndConquer(data, d_val, mode, stddev, sum);
-        auto end = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-        min_duration = std::min(min_duration, duration);
+    // La afinidad se fija antes de crear hilos para que la hereden
+    if (!bench.pin.empty() && !pinToCpus(bench.pin)) {
+        return 1;
     }
+    // Dentro de esa máscara, cada hilo de cálculo a la CPU de su puesto
+    AffinityPolicy affinity;
+    if (!affinity_spec.empty() && !affinity.parse(affinity_spec)) {
+        return 1;
+    }
+    affinity.pinSlot(0);
 
-    std::cout << "Estrategia: " << strategy << "\n";
-    std::cout << "Hilos: " << d_val << "\n";
-    std::cout << "Moda: " << mode << "\n";
-    std::cout << "Desviación estándar: " << stddev << "\n";
-    std::cout << "Suma: " << sum << "\n";
-    std::cout << "Tiempo mínimo: " << min_duration << " microsegundos\n";
+    // El núcleo de cálculo se elige una vez, según la CPU
+    if (!selectStatsKernel(kernel, Accumulator::vectorizable)) {
+        std::cerr << "Error: núcleo '" << kernel << "' no disponible (auto, scalar, avx2, avx512, neon)\n";
+        return 1;
+    }
+
+    // --metrics/--metrics-port: los contadores se activan antes de crear los pools
+    metrics_enabled = metrics_interval > 0 || metrics_port >= 0;
+    MetricsReporter metrics;
+    if (metrics_enabled && !metrics.start(metrics_interval, metrics_port, metrics_bind)) {
+        return 1;
+    }
 
-    std::ofstream out("results.csv", std::ios::app);
-    if (out.is_open()) {
-        out << strategy << "," << ((d_val == 0) ? 1 : (1 << d_val)) << "," << min_duration << "\n";
-        out.close();
-    } else {
-        std::cerr << "Error: no se pudo abrir results.csv\n";
+    std::string strategy = stream ? "Streaming" : numa ? "NUMA" : (batch > 0) ? "Batch"
+                         : (window > 0) ? "Sliding" : async ? "Async" : coro ? "Coroutines" : exact ? "Exact" : "DivideConquer";
+    std::vector<BenchRecord> records;
+
+    // --gpu: la GPU se usa para los tamaños a partir de GPU_MIN_ELEMS si hay alguna
+    const char* gpu_device = nullptr;
+#ifdef STATS_WITH_CUDA
+    if (gpu) {
+        gpu_device = gpuDeviceName();
+        if (!gpu_device) {
+            std::cout << "Aviso: no hay GPU disponible, se calcula en CPU\n";
+        }
+    }
+#endif
+
+    for (std::size_t n : bench.sizes) {
+        GeneratedData generated;
+        MappedFile mapped;
+        DataSpan<Element> data;
+        if (!stream && !numa && !loadDataset(file, n, seed, generated, mapped, data)) {
+            return 1;
+        }
+        // En modo NUMA el fichero se proyecta aquí y se copia con cada pool
+        if (numa && !file.empty() && !mapped.open(file)) {
+            return 1;
+        }
+        // En modo lote los datos se cortan en series independientes
+        std::vector<DataSpan<Element>> series;
+        if (batch > 0) {
+            series = splitSeries(data, batch);
+        }
+
+        for (long long depth : bench.sweep) {
+            // Los hilos se crean una sola vez por configuración, fuera de la región medida.
+            // En modo NUMA y asíncrono el hilo principal no calcula; en NUMA
+            // los datos se colocan de nuevo con los workers ya fijados a su nodo.
+            std::unique_ptr<WorkerPool> owned_pool = numa ? makeNumaPool(divideConquerThreads(depth) + 1)
+                : std::unique_ptr<WorkerPool>(new WorkerPool(divideConquerThreads(depth) + (async ? 1 : 0),
+                                                             affinity.workerStart()));
+            WorkerPool& pool = *owned_pool;
+            if (numa) {
+                numaLoadDataset(pool, file.empty() ? nullptr : &mapped, n, seed, generated, data);
+            }
+
+            double mode = 0, stddev = 0;
+            ProductValue sum;
+            ExactStats exact_stats;
+            BenchRecord record;
+            bool on_gpu = false;
+#ifdef STATS_WITH_CUDA
+            on_gpu = gpu_device && (stream || data.size() >= GPU_MIN_ELEMS); // de un flujo no se sabe el tamaño
+#endif
+            bool ok = measure([&] {
+                if (on_gpu) {
+#ifdef STATS_WITH_CUDA
+                    if (stream) {
+                        StatsPartial<Accumulator> total;
+                        if (!gpuStreamStats<Element>(stream_fd, buffer_elems, total)) {
+                            return false;
+                        }
+                        finalizeStats(total, mode, stddev, sum);
+                    } else if (!gpuStats<Accumulator>(data, mode, stddev, sum)) {
+                        return false;
+                    }
+#endif
+                } else if (stream) {
+                    StatsPartial<Accumulator> total;
+                    if (!streamStats<Element>(pool, stream_fd, buffer_elems, total)) {
+                        return false;
+                    }
+                    finalizeStats(total, mode, stddev, sum);
+                } else if (numa) {
+                    numaStats<Accumulator>(pool, data, mode, stddev, sum);
+                } else if (async) {
+                    StatsResult r = statsAsync<Accumulator>(poolSubmitter(pool), pool.size(), data).get();
+                    mode = r.mode;
+                    stddev = r.stddev;
+                    sum = r.sum;
+                } else if (window > 0) {
+                    // Todas las muestras pasan por la ventana, una actualización cada una
+                    SlidingStats<Element, Accumulator> sliding(window);
+                    for (std::size_t i = 0; i < data.size(); ++i) {
+                        sliding.push(data[i]);
+                    }
+                    sliding.stats(mode, stddev, sum);
+                } else if (batch > 0) {
+                    std::vector<StatsResult> results = batchStats<Accumulator>(pool, series, grain);
+                    mode = results[0].mode;
+                    stddev = results[0].stddev;
+                    sum = results[0].sum;
+                } else if (exact) {
+                    exactStats<Accumulator>(poolSubmitter(pool), pool.size() + 1, data, mode, stddev, sum, exact_stats);
+                } else if (coro) {
+#ifdef STATS_HAVE_COROUTINES
+                    coroutineStats<Accumulator>(pool, data, depth, grain, mode, stddev, sum);
+#endif
+                } else {
+                    divideAndConquer<Accumulator>(pool, data, depth, grain, mode, stddev, sum);
+                }
+                doNotOptimize(mode);
+                doNotOptimize(stddev);
+                doNotOptimize(sum);
+                return true;
+            }, bench.warmup, bench.repetitions, record.summary);
+            if (!ok) {
+                return 1;
+            }
+
+            record.strategy = on_gpu ? "GPU" : strategy;
+            record.param = depth;
+            record.threads = (numa || async) ? pool.size() : pool.size() + 1;
+            record.n = data.size();
+            record.grain = grain;
+            record.kernel = active_stats_kernel.name;
+            record.prefetch = stats_prefetch_bytes;
+            record.affinity = affinity.name();
+            record.element = elementName<Element>();
+            record.accumulator = Accumulator::name();
+            record.warmup = bench.warmup;
+            record.repetitions = bench.repetitions;
+            records.push_back(record);
+            warnImplausibleTiming(record);
+            long long min_duration = record.summary.min_ns / 1000;
+
+            std::cout << "Estrategia: " << record.strategy << "\n";
+            if (on_gpu) {
+                std::cout << "Dispositivo: " << gpu_device << "\n";
+            }
+            std::cout << "Hilos: " << depth << "\n";
+            std::cout << "Núcleo: " << active_stats_kernel.name << "\n";
+            if (stats_prefetch_bytes > 0) {
+                std::cout << "Prefetch: " << stats_prefetch_bytes << " bytes\n";
+            }
+            if (affinity.enabled()) {
+                std::cout << "Afinidad: " << affinity.name() << " (" << affinity.describe(record.threads) << ")\n";
+            }
+            if (batch > 0) {
+                std::cout << "Series: " << batch << " (resultados de la primera)\n";
+            }
+            if (window > 0) {
+                std::cout << "Ventana: " << window << " (resultados de la última, "
+                          << (data.empty() ? 0 : record.summary.min_ns / data.size()) << " ns por muestra)\n";
+            }
+            std::cout << "Moda: " << mode << "\n";
+            std::cout << "Desviación estándar: " << stddev << "\n";
+            std::cout << "Suma: " << sum << "\n";
+            if (exact) {
+                std::cout << "Moda exacta: " << exact_stats.mode << " (" << exact_stats.mode_count << " apariciones)\n";
+                std::cout << "Media: " << exact_stats.mean << "\n";
+                std::cout << "Desviación estándar exacta: " << exact_stats.stddev << "\n";
+                std::cout << "Suma exacta: " << exact_stats.sum << "\n";
+            }
+            std::cout << "Tiempo mínimo: " << min_duration << " microsegundos\n";
+            std::cout << "Tiempos (ns): mediana " << record.summary.median_ns
+                      << ", p90 " << record.summary.p90_ns << ", p99 " << record.summary.p99_ns
+                      << ", desviación " << record.summary.stddev_ns << "\n";
+            if (record.summary.allocs_per_call >= 0) {
+                std::cout << "Reservas por llamada: " << record.summary.allocs_per_call << "\n";
+            }
+
+            std::ofstream out("results.csv", std::ios::app);
+            if (out.is_open()) {
+                out << record.strategy << "," << ((depth == 0) ? 1 : (1LL << depth)) << "," << min_duration << "\n";
+                out.close();
+            } else {
+                std::cerr << "Error: no se pudo abrir results.csv\n";
+            }
+        }
+    }
+
+    if (!bench.output.empty() && !writeBenchRecords(bench.output, records)) {
+        return 1;
+    }
+    if (!trace_file.empty() && !traceDump(trace_file)) {
+        return 1;
     }
 
     return 0;
@@ -2,183 +2,332 @@
 #include <vector>
 #include <cmath>
 #include <thread>
-#include <mutex>
-#include <chrono>
 #include <getopt.h>
 #include <cstdlib>
 #include <fstream>
 #include <limits>
 #include <algorithm>
+#include <atomic>
+#include <memory>
+#include <sstream>
+#include <string>
 #include <QCoreApplication>
 #include <QThreadPool>
 #include <QRunnable>
-
-// Clase para manejar las tareas estadísticas
-class StatsTask {
-    const std::vector<double>& data;
-    int start, end;
-    double& global_log_sum;
-    double& global_sum;
-    double& global_diff_sum;
-    std::mutex& mutex;
-    bool& has_zero;
-    int& global_count;
+#include "adaptive.h"
+#include "affinity.h"
+#include "async_stats.h"
+#include "benchmark.h"
+#include "coro_stats.h"
+#include "chunking.h"
+#include "dataset.h"
+#include "divide_conquer.h"
+#include "exact_stats.h"
+#include "latch.h"
+#include "metrics.h"
+#include "mpi_stats.h"
+#include "scheduler.h"
+#include "stats_task.h"
+#include "stream_stats.h"
+#include "trace.h"
+#include "work_stealing.h"
+#include "worker_pool.h"
+
+// Clase para tareas de QThreadPool. No se borra al terminar: se reutiliza
+// en la siguiente llamada apuntando a otra tarea (ver ThreadPoolArena).
+// Al acabar descuenta el latch de la llamada en lugar de esperar a
+// waitForDone(), que duerme al llamante.
+template <typename T, typename Acc>
+class StatsRunnable : public QRunnable {
+    StatsTask<T, Acc>* task = nullptr;
+    CompletionLatch* latch = nullptr;
 
 public:
-    StatsTask(const std::vector<double>& d, int s, int e,
-              double& gls, double& gs, double& gds, std::mutex& mtx, bool& hz, int& gc)
-        : data(d), start(s), end(e),
-          global_log_sum(gls), global_sum(gs), global_diff_sum(gds),
-          mutex(mtx), has_zero(hz), global_count(gc) {}
-
-    void computeMetrics() {
-        double local_log_sum = 0.0;
-        double local_sum = 0.0;
-        double local_diff_sum = 0.0;
-        bool local_has_zero = false;
-        int local_count = 0;
-
-        for (int i = start; i < end; ++i) {
-            double val = data[i];
-            if (val == 0) {
-                local_has_zero = true;
-            } else {
-                local_log_sum += std::log(std::abs(val));
-            }
-            local_sum += val;
-            local_diff_sum += (val - i); // Moda: data[i] - i
-            local_count++;
-        }
+    StatsRunnable() {
+        setAutoDelete(false);
+    }
 
-        std::lock_guard<std::mutex> lock(mutex);
-        global_log_sum += local_log_sum;
-        global_sum += local_sum;
-        global_diff_sum += local_diff_sum;
-        has_zero = has_zero || local_has_zero;
-        global_count += local_count;
+    void bind(StatsTask<T, Acc>* t, CompletionLatch* l) {
+        task = t;
+        latch = l;
+    }
+
+    void run() override {
+        task->computeMetrics();
+        latch->countDown();
     }
 };
 
-// Clase para tareas de QThreadPool
-class StatsRunnable : public QRunnable {
-    StatsTask& task;
+// Memoria reutilizable de threadPool(): tareas y parciales en un TaskArena y
+// un runnable por trozo que sólo se crea la primera vez que hace falta
+template <typename T, typename Acc>
+struct ThreadPoolArena {
+    TaskArena tasks;
+    std::vector<std::unique_ptr<StatsRunnable<T, Acc>>> runnables;
+    CompletionLatch remaining;
+
+    StatsRunnable<T, Acc>* runnable(std::size_t i) {
+        while (runnables.size() <= i) {
+            runnables.emplace_back(new StatsRunnable<T, Acc>);
+        }
+        return runnables[i].get();
+    }
+};
+
+// Crea de antemano los hilos del QThreadPool: cada tarea espera a que todas
+// las demás hayan arrancado, obligando al pool a levantar num_threads hilos.
+// Como cada tarea ocupa un hilo distinto, es también donde se fija su
+// afinidad: QThreadPool no avisa al arrancar sus hilos.
+void warmUpThreadPool(QThreadPool& pool, int num_threads, const AffinityPolicy& affinity) {
+    pool.setMaxThreadCount(num_threads);
+    pool.setExpiryTimeout(-1); // los hilos no caducan entre ejecuciones
+    std::atomic<int> started(0);
+    for (int i = 0; i < num_threads; ++i) {
+        pool.start([&started, &affinity, num_threads] {
+            affinity.pinSlot(started.fetch_add(1) + 1);
+            while (started.load() < num_threads) {
+                std::this_thread::yield();
+            }
+        });
+    }
+    pool.waitForDone();
+}
+
+// Parte de un parallelFor encolada en el QThreadPool; como StatsRunnable, no
+// se borra al terminar y se reutiliza en la siguiente llamada
+class PartRunnable : public QRunnable {
+    const std::function<void(int)>* f = nullptr;
+    CompletionLatch* latch = nullptr;
+    int part = 0;
 
 public:
-    StatsRunnable(StatsTask& t) : task(t) {
-        setAutoDelete(true); // QThreadPool elimina la tarea automáticamente
+    PartRunnable() {
+        setAutoDelete(false);
+    }
+
+    void bind(const std::function<void(int)>* fn, CompletionLatch* l, int i) {
+        f = fn;
+        latch = l;
+        part = i;
     }
 
     void run() override {
-        task.computeMetrics();
+        (*f)(part);
+        latch->countDown();
     }
 };
 
-// Divide and Conquer strategy
-void divideAndConquer(const std::vector<double>& data, int splits,
-                      double& mode, double& stddev, double& sum) {
-    if (data.empty()) {
-        mode = 0;
-        stddev = 0;
-        sum = 0;
-        return;
-    }
+// Planificador de scheduler.h sobre QThreadPool: el llamante hace la parte 0
+// y los num_threads - 1 hilos del pool, el resto
+class QThreadPoolScheduler : public TaskScheduler {
+    QThreadPool& pool;
+    int num_threads;
+    std::vector<std::unique_ptr<PartRunnable>> runnables;
+    CompletionLatch remaining;
 
-    int size = data.size();
-    if (splits < 0 || splits > 5) {
-        std::cerr << "Error: -d VALOR debe estar entre 0 y 5\n";
-        return;
+public:
+    QThreadPoolScheduler(QThreadPool& p, int n, const AffinityPolicy& affinity) : pool(p), num_threads(n) {
+        warmUpThreadPool(pool, std::max(1, num_threads - 1), affinity);
     }
 
-    int parts = (splits == 0) ? 1 : (1 << splits);
-    double global_log_sum = 0.0, global_sum = 0.0, global_diff_sum = 0.0;
-    bool has_zero = false;
-    int global_count = 0;
-    std::mutex mutex;
+    const char* name() const override { return "qthreadpool"; }
+    int threads() const override { return num_threads; }
 
-    int chunk_size = size / parts;
-    if (chunk_size == 0) {
-        parts = size;
-        chunk_size = 1;
+    void parallelFor(int parts, const std::function<void(int)>& f) override {
+        remaining.reset(parts > 0 ? parts - 1 : 0);
+        for (int i = 1; i < parts; ++i) {
+            while (runnables.size() < static_cast<std::size_t>(i)) {
+                runnables.emplace_back(new PartRunnable);
+            }
+            runnables[i - 1]->bind(&f, &remaining, i);
+            pool.start(runnables[i - 1].get());
+        }
+        if (parts > 0) {
+            f(0);
+        }
+        remaining.wait();
     }
+};
 
-    std::vector<StatsTask> tasks;
-    std::vector<std::thread> threads;
-    tasks.reserve(parts);
+// Parcial de threadPool() sin finalizar; base es el índice global de
+// data[0], distinto de 0 cuando data es la parte de un proceso MPI
+template <typename Acc, typename T>
+StatsPartial<Acc> threadPoolPartial(QThreadPool& pool, ThreadPoolArena<T, Acc>& arena, DataSpan<T> data,
+                                    int num_threads, long long base = 0) {
+    if (data.empty()) {
+        return StatsPartial<Acc>();
+    }
 
-    for (int i = 0; i < parts; ++i) {
-        int start = i * chunk_size;
-        int end = (i == parts - 1) ? size : start + chunk_size;
-        tasks.emplace_back(data, start, end, global_log_sum, global_sum, global_diff_sum, mutex, has_zero, global_count);
-        if (parts == 1) {
-            tasks.back().computeMetrics();
-        } else {
-            threads.emplace_back(&StatsTask::computeMetrics, &tasks.back());
+    std::size_t size = data.size();
+    // Como mucho un trozo por hilo y nunca trozos diminutos (ver chunking.h)
+    std::size_t num_tasks = chunkCount(size, num_threads);
+    arena.tasks.reset();
+    StatsPartial<Acc>* partials = arena.tasks.template allocate<StatsPartial<Acc>>(num_tasks);
+    StatsTask<T, Acc>* tasks = arena.tasks.template allocate<StatsTask<T, Acc>>(num_tasks);
+
+    // Enqueue tasks for metrics; el trozo 0 lo calcula el propio llamante
+    long long begin = traceNow();
+    arena.remaining.reset(static_cast<int>(num_tasks) - 1);
+    for (std::size_t i = 0; i < num_tasks; ++i) {
+        std::size_t start = chunkBoundary(data.ptr, size, num_tasks, i);
+        std::size_t end = chunkBoundary(data.ptr, size, num_tasks, i + 1);
+        new (&partials[i]) StatsPartial<Acc>();
+        new (&tasks[i]) StatsTask<T, Acc>(data, start, end, partials[i], base);
+        if (i > 0) {
+            tasks[i].markEnqueued();
+            StatsRunnable<T, Acc>* runnable = arena.runnable(i);
+            runnable->bind(&tasks[i], &arena.remaining);
+            pool.start(runnable);
         }
     }
+    traceSpan("QThreadPool::start", begin);
+    tasks[0].computeMetrics();
 
-    for (auto& t : threads) {
-        t.join();
-    }
+    // Wait for tasks to complete: espera activa acotada y después futex
+    begin = traceNow();
+    arena.remaining.wait();
+    traceSpan("latch wait", begin);
 
-    mode = global_count > 0 ? global_diff_sum / global_count : 0.0; // Moda: promedio de diferencias
-    stddev = global_sum / 2.0; // Desviación estándar: suma total / 2
-    sum = has_zero ? 0 : std::exp(global_log_sum); // Sumatoria: producto
+    return reducePartials(partials, num_tasks);
 }
 
-// Thread Pool strategy con QThreadPool
-void threadPool(const std::vector<double>& data, int num_threads,
-                double& mode, double& stddev, double& sum) {
+// Thread Pool strategy con QThreadPool (persistente, ver warmUpThreadPool)
+template <typename Acc, typename T>
+void threadPool(QThreadPool& pool, ThreadPoolArena<T, Acc>& arena, DataSpan<T> data, int num_threads,
+                double& mode, double& stddev, ProductValue& sum) {
     if (data.empty()) {
         mode = 0;
         stddev = 0;
-        sum = 0;
+        sum = ProductValue();
         return;
     }
 
-    int size = data.size();
     if (num_threads < 1 || num_threads > 32) {
         std::cerr << "Error: -p VALOR debe estar entre 1 y 32\n";
         return;
     }
 
-    double global_log_sum = 0.0, global_sum = 0.0, global_diff_sum = 0.0;
-    bool has_zero = false;
-    int global_count = 0;
-    std::mutex mutex;
+    finalizeStats(threadPoolPartial(pool, arena, data, num_threads), mode, stddev, sum);
+}
 
-    QThreadPool pool;
-    pool.setMaxThreadCount(num_threads);
-    int chunk_size = size / num_threads;
-    if (chunk_size == 0) {
-        num_threads = size;
-        chunk_size = 1;
+// Work Stealing strategy: trozos finos repartidos en colas por hilo
+template <typename Acc, typename T>
+void workStealing(WorkStealingPool& pool, DataSpan<T> data,
+                  double& mode, double& stddev, ProductValue& sum) {
+    if (data.empty()) {
+        mode = 0;
+        stddev = 0;
+        sum = ProductValue();
+        return;
     }
 
-    std::vector<StatsTask> tasks;
-    tasks.reserve(num_threads);
+    std::size_t size = data.size();
+    int num_tasks = static_cast<int>(chunkCount(size, pool.size(), WorkStealingPool::TASKS_PER_WORKER));
 
-    // Enqueue tasks for metrics
-    for (int i = 0; i < num_threads; ++i) {
-        int start = i * chunk_size;
-        int end = (i == num_threads - 1) ? size : start + chunk_size;
-        tasks.emplace_back(data, start, end, global_log_sum, global_sum, global_diff_sum, mutex, has_zero, global_count);
-        pool.start(new StatsRunnable(tasks[i]));
+    pool.arena().reset();
+    StatsPartial<Acc>* partials = pool.arena().allocate<StatsPartial<Acc>>(num_tasks);
+    StatsTask<T, Acc>* tasks = pool.arena().allocate<StatsTask<T, Acc>>(num_tasks);
+
+    // Reparto equilibrado: el resto se distribuye en lugar de ir al último trozo
+    for (int i = 0; i < num_tasks; ++i) {
+        std::size_t start = chunkBoundary(data.ptr, size, num_tasks, i);
+        std::size_t end = chunkBoundary(data.ptr, size, num_tasks, i + 1);
+        new (&partials[i]) StatsPartial<Acc>();
+        new (&tasks[i]) StatsTask<T, Acc>(data, start, end, partials[i]);
+        tasks[i].markEnqueued();
     }
 
-    // Wait for tasks to complete
-    pool.waitForDone();
+    long long begin = traceNow();
+    pool.run(num_tasks, [tasks](int t) { tasks[t].computeMetrics(); });
+    traceSpan("run", begin);
 
-    mode = global_count > 0 ? global_diff_sum / global_count : 0.0; // Moda: promedio de diferencias
-    stddev = global_sum / 2.0; // Desviación estándar: suma total / 2
-    sum = has_zero ? 0 : std::exp(global_log_sum); // Sumatoria: producto
+    finalizeStats(reducePartials(partials, num_tasks), mode, stddev, sum);
+}
+
+// Tarea vacía para medir lo que cuesta repartir trabajo en el QThreadPool
+class NoopRunnable : public QRunnable {
+public:
+    NoopRunnable() {
+        setAutoDelete(false);
+    }
+
+    void run() override {}
+};
+
+// Calibra el modelo de coste de -a con los pools que usará la estrategia
+template <typename Acc>
+TuningProfile calibrateProfile(WorkerPool& pool, QThreadPool& qpool, int max_threads) {
+    const int reps = 200;
+    TuningProfile profile;
+    profile.kernel = active_stats_kernel.name;
+    profile.element = elementName<Element>();
+    profile.accumulator = Acc::name();
+    profile.max_threads = max_threads;
+    profile.elem_ns = calibrateElementCost<Acc>();
+
+    // Un nivel de DivideConquer: encolar la mitad derecha y esperarla
+    profile.fork_ns = minTimeNs([&pool] {
+        std::atomic<bool> done(false);
+        pool.submit([&done] { done.store(true, std::memory_order_release); });
+        pool.helpUntil(done);
+    }, reps);
+
+    std::vector<NoopRunnable> noops(max_threads);
+    profile.dispatch_ns = minTimeNs([&] {
+        qpool.start(&noops[0]);
+        qpool.waitForDone();
+    }, reps);
+    if (max_threads > 1) {
+        double all = minTimeNs([&] {
+            for (NoopRunnable& r : noops) {
+                qpool.start(&r);
+            }
+            qpool.waitForDone();
+        }, reps);
+        profile.task_ns = std::max(0.0, (all - profile.dispatch_ns) / (max_threads - 1));
+    }
+    return profile;
 }
-// ... (resto del código sin cambios hasta main) ...
 
 int main(int argc, char* argv[]) {
     QCoreApplication app(argc, argv);
 
-    int opt, d_val = -1, p_val = -1;
-    while ((opt = getopt(argc, argv, "d:p:")) != -1) {
+    static const option long_options[] = {
+        {"warmup", required_argument, nullptr, 'W'},
+        {"reps", required_argument, nullptr, 'R'},
+        {"pin", required_argument, nullptr, 'P'},
+        {"sweep", required_argument, nullptr, 'X'},
+        {"sizes", required_argument, nullptr, 'N'},
+        {"bench-out", required_argument, nullptr, 'O'},
+        {"trace", required_argument, nullptr, 'T'},
+        {"async", no_argument, nullptr, 'Y'},
+        {"profile", required_argument, nullptr, 'F'},
+        {"exact", no_argument, nullptr, 'E'},
+        {"prefetch", required_argument, nullptr, 'H'},
+        {"affinity", required_argument, nullptr, 'I'},
+        {"metrics", required_argument, nullptr, 'K'},
+        {"metrics-port", required_argument, nullptr, 'U'},
+        {"metrics-bind", required_argument, nullptr, 'V'},
+        {"scheduler", required_argument, nullptr, 'J'},
+        {"mpi", no_argument, nullptr, 'Q'},
+        {nullptr, 0, nullptr, 0}
+    };
+
+    int opt, d_val = -1, p_val = -1, w_val = -1, c_val = -1, x_val = -1, grain = DEFAULT_GRAIN;
+    std::string kernel = "auto", file;
+    std::size_t n_val = 0;
+    std::uint64_t seed = 42;
+    bool seed_set = false, stream = false;
+    std::size_t buffer_elems = DEFAULT_STREAM_BUFFER;
+    BenchOptions bench;
+    std::string trace_file, affinity_spec;
+    int metrics_interval = 0, metrics_port = -1;
+    std::string metrics_bind = DEFAULT_METRICS_BIND;
+    bool async = false, adaptive = false, exact = false, mpi = false;
+    std::string profile_file = DEFAULT_TUNING_PROFILE;
+    std::string scheduler_list = "qthreadpool," + schedulerNames();
+    std::vector<long long> list;
+    while ((opt = getopt_long(argc, argv, "d:p:w:c:x:ag:k:n:s:f:SB:", long_options, nullptr)) != -1) {
         if (opt == 'd') {
             d_val = std::atoi(optarg);
             if (d_val < 0 || d_val > 5) {
@@ -191,62 +340,476 @@ int main(int argc, char* argv[]) {
                 std::cerr << "Error: -p VALOR debe estar entre 1 y 32\n";
                 return 1;
             }
+        } else if (opt == 'w') {
+            w_val = std::atoi(optarg);
+            if (w_val < 1 || w_val > 32) {
+                std::cerr << "Error: -w VALOR debe estar entre 1 y 32\n";
+                return 1;
+            }
+        } else if (opt == 'x') {
+            x_val = std::atoi(optarg);
+            if (x_val < 1 || x_val > 32) {
+                std::cerr << "Error: -x VALOR debe estar entre 1 y 32\n";
+                return 1;
+            }
+        } else if (opt == 'c') {
+            c_val = std::atoi(optarg);
+            if (c_val < 0 || c_val > 5) {
+                std::cerr << "Error: -c VALOR debe estar entre 0 y 5\n";
+                return 1;
+            }
+#ifndef STATS_HAVE_COROUTINES
+            std::cerr << "Error: -c requiere compilar con corrutinas de C++20 (qmake CONFIG+=coro)\n";
+            return 1;
+#endif
+        } else if (opt == 'a') {
+            adaptive = true;
+        } else if (opt == 'g') {
+            grain = std::atoi(optarg);
+            if (grain < 1) {
+                std::cerr << "Error: -g GRANO debe ser mayor que 0\n";
+                return 1;
+            }
+        } else if (opt == 'k') {
+            kernel = optarg;
+        } else if (opt == 'n') {
+            n_val = std::strtoull(optarg, nullptr, 10);
+            if (n_val == 0) {
+                std::cerr << "Error: -n VALOR debe ser mayor que 0\n";
+                return 1;
+            }
+        } else if (opt == 's') {
+            seed = std::strtoull(optarg, nullptr, 10);
+            seed_set = true;
+        } else if (opt == 'f') {
+            file = optarg;
+        } else if (opt == 'S') {
+            stream = true;
+        } else if (opt == 'B') {
+            buffer_elems = std::strtoull(optarg, nullptr, 10);
+            if (buffer_elems == 0) {
+                std::cerr << "Error: -B VALOR debe ser mayor que 0\n";
+                return 1;
+            }
+        } else if (opt == 'W') {
+            bench.warmup = std::atoi(optarg);
+            if (bench.warmup < 0) {
+                std::cerr << "Error: --warmup VALOR no puede ser negativo\n";
+                return 1;
+            }
+        } else if (opt == 'R') {
+            bench.repetitions = std::atoi(optarg);
+            if (bench.repetitions < 1) {
+                std::cerr << "Error: --reps VALOR debe ser mayor que 0\n";
+                return 1;
+            }
+        } else if (opt == 'P') {
+            bench.pin = optarg;
+        } else if (opt == 'X') {
+            if (!parseList(optarg, bench.sweep)) {
+                std::cerr << "Error: --sweep espera una lista como 1,2,4 o 1-8\n";
+                return 1;
+            }
+        } else if (opt == 'N') {
+            if (!parseList(optarg, list)) {
+                std::cerr << "Error: --sizes espera una lista como 1000,1000000\n";
+                return 1;
+            }
+            for (long long v : list) {
+                if (v < 1) {
+                    std::cerr << "Error: -n VALOR debe ser mayor que 0\n";
+                    return 1;
+                }
+                bench.sizes.push_back(v);
+            }
+        } else if (opt == 'O') {
+            bench.output = optarg;
+        } else if (opt == 'Y') {
+            async = true;
+        } else if (opt == 'E') {
+            exact = true;
+        } else if (opt == 'Q') {
+            mpi = true;
+#ifndef STATS_WITH_MPI
+            std::cerr << "Error: --mpi requiere compilar con MPI (qmake CONFIG+=mpi)\n";
+            return 1;
+#endif
+        } else if (opt == 'J') {
+            scheduler_list = optarg;
+        } else if (opt == 'K' || opt == 'U') {
+            char* end = nullptr;
+            long value = std::strtol(optarg, &end, 10);
+            if (end == optarg || *end != '\0' || value < 0 || (opt == 'U' && value > 65535)) {
+                std::cerr << (opt == 'K' ? "Error: --metrics espera un periodo en segundos\n"
+                                         : "Error: --metrics-port espera un puerto entre 0 y 65535\n");
+                return 1;
+            }
+            (opt == 'K' ? metrics_interval : metrics_port) = static_cast<int>(value);
+        } else if (opt == 'V') {
+            metrics_bind = optarg;
+        } else if (opt == 'I') {
+            affinity_spec = optarg;
+        } else if (opt == 'H') {
+            char* end = nullptr;
+            stats_prefetch_bytes = std::strtoull(optarg, &end, 10);
+            if (end == optarg || *end != '\0') {
+                std::cerr << "Error: --prefetch espera una distancia en bytes (0 la desactiva)\n";
+                return 1;
+            }
+        } else if (opt == 'F') {
+            profile_file = optarg;
+        } else if (opt == 'T') {
+            trace_file = optarg;
+#ifndef STATS_TRACE
+            std::cerr << "Error: --trace requiere compilar con STATS_TRACE (qmake CONFIG+=trace)\n";
+            return 1;
+#endif
         }
     }
 
-    if (d_val == -1 && p_val == -1) {
-        std::cerr << "Error: debe especificar -d o -p\n";
+    int selected = (d_val != -1) + (p_val != -1) + (w_val != -1) + (c_val != -1) + (x_val != -1) + adaptive;
+    if (async && p_val == -1) {
+        std::cerr << "Error: --async sólo puede usarse con -p\n";
+        return 1;
+    }
+    if (exact && (p_val == -1 || async)) {
+        std::cerr << "Error: --exact sólo puede usarse con -p, sin --async\n";
+        return 1;
+    }
+    if (mpi && (p_val == -1 || async || exact || stream)) {
+        std::cerr << "Error: --mpi sólo puede usarse con -p, sin --async ni --exact\n";
+        return 1;
+    }
+    if (stream && d_val == -1) {
+        std::cerr << "Error: -S sólo puede usarse con -d\n";
+        return 1;
+    }
+    if (selected == 0) {
+        std::cerr << "Error: debe especificar -d, -p, -w, -c, -x o -a\n";
+        return 1;
+    }
+    if (selected > 1) {
+        std::cerr << "Error: no puede usar -d, -p, -w, -c, -x y -a juntos\n";
+        return 1;
+    }
+    // -x compara en la misma ejecución los planificadores de --scheduler
+    std::vector<std::string> schedulers(1);
+    if (x_val != -1) {
+        std::string available = "qthreadpool," + schedulerNames();
+        std::stringstream names(scheduler_list);
+        schedulers.clear();
+        for (std::string name; std::getline(names, name, ',');) {
+            if (("," + available + ",").find("," + name + ",") == std::string::npos || name.empty()) {
+                std::cerr << "Error: planificador '" << name << "' no disponible (" << available << ")\n";
+                return 1;
+            }
+            schedulers.push_back(name);
+        }
+    }
+    if (adaptive && !bench.sweep.empty()) {
+        std::cerr << "Error: -a elige los hilos por sí mismo, no admite --sweep\n";
         return 1;
     }
-    if (d_val != -1 && p_val != -1) {
-        std::cerr << "Error: no puede usar -d y -p juntos\n";
+
+    // --sweep recorre valores del parámetro de la estrategia elegida
+    std::string strategy = stream ? "Streaming"
+                         : adaptive ? "Adaptive"
+                         : (d_val != -1) ? "DivideConquer"
+                         : (c_val != -1) ? "Coroutines"
+                         : (x_val != -1) ? "Scheduler"
+                         : (p_val != -1) ? (async ? "ThreadPoolAsync" : exact ? "ThreadPoolExact" : mpi ? "ThreadPoolMPI" : "ThreadPool")
+                         : "WorkStealing";
+    if (bench.sweep.empty()) {
+        bench.sweep.push_back(adaptive ? 0 : (d_val != -1) ? d_val : (c_val != -1) ? c_val : (p_val != -1) ? p_val : (x_val != -1) ? x_val : w_val);
+    }
+    bool recursive = d_val != -1 || c_val != -1;
+    for (long long v : bench.sweep) {
+        if (recursive && (v < 0 || v > 5)) {
+            std::cerr << "Error: " << ((d_val != -1) ? "-d" : "-c") << " VALOR debe estar entre 0 y 5\n";
+            return 1;
+        }
+        if (!recursive && !adaptive && (v < 1 || v > 32)) {
+            std::cerr << "Error: " << ((p_val != -1) ? "-p" : (x_val != -1) ? "-x" : "-w") << " VALOR debe estar entre 1 y 32\n";
+            return 1;
+        }
+    }
+
+    if (!file.empty() && (n_val != 0 || !bench.sizes.empty())) {
+        std::cerr << "Error: no puede usar -f y -n juntos\n";
         return 1;
     }
+    if (seed_set && n_val == 0) {
+        n_val = 100;
+    }
+    if (bench.sizes.empty()) {
+        bench.sizes.push_back(n_val);
+    }
 
-    std::vector<double> data(100);
-    std::srand(42);
-    for (int i = 0; i < 100; ++i) {
-        data[i] = std::round((std::rand() / (double)RAND_MAX) * 100);
+    // En modo flujo los datos se leen por buffers durante el cálculo
+    int stream_fd = -1;
+    if (stream) {
+        if (n_val != 0 || bench.sizes.size() > 1 || bench.sweep.size() > 1) {
+            std::cerr << "Error: -S lee de -f o de la entrada estándar, sin -n ni barridos\n";
+            return 1;
+        }
+        stream_fd = openStreamInput(file);
+        if (stream_fd < 0) {
+            return 1;
+        }
+        bench.warmup = 0;
+        bench.repetitions = 1; // un flujo sólo puede leerse una vez
     }
 
-    double mode = 0, stddev = 0, sum = 0;
-    const int RUNS = 5;
-    long min_duration = std::numeric_limits<long>::max();
-    std::string strategy;
-    int num_threads = 0;
+    // La afinidad se fija antes de crear hilos para que la hereden
+    if (!bench.pin.empty() && !pinToCpus(bench.pin)) {
+        return 1;
+    }
+    // Dentro de esa máscara, cada hilo de cálculo a la CPU de su puesto
+    AffinityPolicy affinity;
+    if (!affinity_spec.empty() && !affinity.parse(affinity_spec)) {
+        return 1;
+    }
+    affinity.pinSlot(0);
+
+    // El núcleo de cálculo se elige una vez, según la CPU
+    if (!selectStatsKernel(kernel, Accumulator::vectorizable)) {
+        std::cerr << "Error: núcleo '" << kernel << "' no disponible (auto, scalar, avx2, avx512, neon)\n";
+        return 1;
+    }
 
-    for (int i = 0; i < RUNS; ++i) {
-        // Barrera de memoria para evitar optimizaciones
-        std::atomic_thread_fence(std::memory_order_seq_cst);
-        auto start = std::chrono::steady_clock::now(); // Usar steady_clock
-        if (d_val != -1) {
-            strategy = "DivideConquer";
-            num_threads = (d_val == 0) ? 1 : (1 << d_val);
-            divideAndConquer(data, d_val, mode, stddev, sum);
+    // --mpi: MPI se inicia después de validar las opciones y se cierra al salir
+    int mpi_rank = 0, mpi_size = 1;
+#ifdef STATS_WITH_MPI
+    std::unique_ptr<MpiSession> mpi_session;
+    std::vector<StatsPartial<Accumulator>> mpi_gathered;
+    if (mpi) {
+        mpi_session.reset(new MpiSession(&argc, &argv));
+        mpi_rank = mpi_session->rank();
+        mpi_size = mpi_session->size();
+    }
+#endif
+    // Tras iniciar MPI, los fallos que no ocurren en todos los procesos a la
+    // vez se ponen en común antes de salir (ver mpiAllOk)
+    auto allOk = [&](bool ok) {
+#ifdef STATS_WITH_MPI
+        if (mpi_session) {
+            return mpiAllOk(*mpi_session, ok);
+        }
+#endif
+        return ok;
+    };
+
+    // --metrics/--metrics-port: los contadores se activan antes de crear los
+    // pools; con --mpi cada proceso escucha en el puerto dado más su rango
+    metrics_enabled = metrics_interval > 0 || metrics_port >= 0;
+    MetricsReporter metrics;
+    if (!allOk(!metrics_enabled || metrics.start(metrics_interval, metrics_port >= 0 ? metrics_port + mpi_rank : -1, metrics_bind))) {
+        return 1;
+    }
+
+    QThreadPool* qpool = QThreadPool::globalInstance();
+    ThreadPoolArena<Element, Accumulator> qpool_arena;
+    std::vector<BenchRecord> records;
+
+    // -a: pools con todos los núcleos y perfil de costes cargado o calibrado
+    int max_threads = std::min(32, std::max(1, static_cast<int>(std::thread::hardware_concurrency())));
+    std::unique_ptr<WorkerPool> adaptive_pool;
+    TuningProfile profile;
+    if (adaptive) {
+        adaptive_pool.reset(new WorkerPool(max_threads - 1, affinity.workerStart()));
+        warmUpThreadPool(*qpool, max_threads, affinity);
+        TuningProfile expected;
+        expected.kernel = active_stats_kernel.name;
+        expected.element = elementName<Element>();
+        expected.accumulator = Accumulator::name();
+        expected.max_threads = max_threads;
+        if (loadTuningProfile(profile_file, profile) && profile.sameSetup(expected)) {
+            std::cout << "Perfil: " << profile_file << "\n";
         } else {
-            strategy = "ThreadPool";
-            num_threads = p_val;
-            threadPool(data, p_val, mode, stddev, sum);
+            profile = calibrateProfile<Accumulator>(*adaptive_pool, *qpool, max_threads);
+            if (!allOk(saveTuningProfile(profile_file, profile))) {
+                return 1;
+            }
+            std::cout << "Perfil: " << profile_file << " (calibrado)\n";
         }
-        std::atomic_thread_fence(std::memory_order_seq_cst);
-        auto end = std::chrono::steady_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-        min_duration = std::min(min_duration, duration);
-    }
-
-    std::cout << "Estrategia: " << strategy << "\n";
-    std::cout << "Hilos: " << num_threads << "\n";
-    std::cout << "Moda: " << mode << "\n";
-    std::cout << "Desviación estándar: " << stddev << "\n";
-    std::cout << "Suma: " << sum << "\n";
-    std::cout << "Tiempo mínimo: " << min_duration << " microsegundos\n";
-
-    std::ofstream out("results.csv", std::ios::app);
-    if (out.is_open()) {
-        out << strategy << "," << num_threads << "," << min_duration << "\n";
-        out.close();
-    } else {
-        std::cerr << "Error: no se pudo abrir results.csv\n";
+    }
+
+    for (std::size_t n : bench.sizes) {
+        GeneratedData generated;
+        MappedFile mapped;
+        DataSpan<Element> data;
+        [[maybe_unused]] std::size_t shard_first = 0; // índice global de data[0] con --mpi
+        std::size_t total_n = 0;
+        if (mpi) {
+#ifdef STATS_WITH_MPI
+            if (!allOk(mpiLoadShard(*mpi_session, file, n, seed, generated, mapped, data, shard_first, total_n))) {
+                return 1;
+            }
+#endif
+        } else if (!stream && !loadDataset(file, n, seed, generated, mapped, data)) {
+            return 1;
+        } else {
+            total_n = data.size();
+        }
+
+        for (std::size_t config = 0; config < bench.sweep.size() * schedulers.size(); ++config) {
+            // Los hilos se crean una sola vez por configuración, fuera de la región medida
+            int param = static_cast<int>(bench.sweep[config / schedulers.size()]);
+            const std::string& backend = schedulers[config % schedulers.size()];
+            int num_threads = 0;
+            std::unique_ptr<WorkerPool> pool;
+            std::unique_ptr<WorkStealingPool> stealing_pool;
+            std::unique_ptr<TaskScheduler> scheduler;
+            ExecutionPlan plan;
+            if (adaptive) {
+                plan = choosePlan(profile, data.size(), max_threads);
+                num_threads = plan.threads;
+            } else if (recursive) {
+                pool.reset(new WorkerPool(divideConquerThreads(param), affinity.workerStart()));
+                num_threads = stream ? pool->size() + 1 : (param == 0) ? 1 : (1 << param);
+            } else if (x_val != -1) {
+                scheduler = (backend == "qthreadpool")
+                    ? std::unique_ptr<TaskScheduler>(new QThreadPoolScheduler(*qpool, param, affinity))
+                    : makeScheduler(backend, param, affinity);
+                num_threads = scheduler->threads();
+            } else if (p_val != -1) {
+                warmUpThreadPool(*qpool, param, affinity);
+                num_threads = param;
+            } else {
+                stealing_pool.reset(new WorkStealingPool(param, affinity.workerStart()));
+                num_threads = param;
+            }
+
+            double mode = 0, stddev = 0;
+            ProductValue sum;
+            ExactStats exact_stats;
+            BenchRecord record;
+            bool ok = measure([&] {
+                if (stream) {
+                    StatsPartial<Accumulator> total;
+                    if (!streamStats<Element>(*pool, stream_fd, buffer_elems, total)) {
+                        return false;
+                    }
+                    finalizeStats(total, mode, stddev, sum);
+                } else if (adaptive && plan.kind == PLAN_DIVIDE_CONQUER) {
+                    divideAndConquer<Accumulator>(*adaptive_pool, data, plan.depth, plan.grain, mode, stddev, sum);
+                } else if (adaptive && plan.kind == PLAN_THREAD_POOL) {
+                    threadPool<Accumulator>(*qpool, qpool_arena, data, plan.threads, mode, stddev, sum);
+                } else if (adaptive) {
+                    // Entrada pequeña: repartirla costaría más que calcularla
+                    StatsPartial<Accumulator> total;
+                    StatsTask<Element, Accumulator>(data, 0, data.size(), total).computeMetrics();
+                    finalizeStats(total, mode, stddev, sum);
+                } else if (d_val != -1) {
+                    divideAndConquer<Accumulator>(*pool, data, param, grain, mode, stddev, sum);
+                } else if (c_val != -1) {
+#ifdef STATS_HAVE_COROUTINES
+                    coroutineStats<Accumulator>(*pool, data, param, grain, mode, stddev, sum);
+#endif
+                } else if (p_val != -1 && async) {
+                    // Los trozos se encolan en el QThreadPool y el último reduce
+                    auto submit = [qpool](std::function<void()> task) { qpool->start(std::move(task)); };
+                    StatsResult r = statsAsync<Accumulator>(submit, param, data).get();
+                    mode = r.mode;
+                    stddev = r.stddev;
+                    sum = r.sum;
+                } else if (p_val != -1 && exact) {
+                    auto submit = [qpool](std::function<void()> task) { qpool->start(std::move(task)); };
+                    exactStats<Accumulator>(submit, param, data, mode, stddev, sum, exact_stats);
+                } else if (p_val != -1 && mpi) {
+#ifdef STATS_WITH_MPI
+                    StatsPartial<Accumulator> local = threadPoolPartial<Accumulator>(
+                        *qpool, qpool_arena, data, param, static_cast<long long>(shard_first));
+                    finalizeStats(mpiReducePartials(*mpi_session, local, mpi_gathered), mode, stddev, sum);
+#endif
+                } else if (p_val != -1) {
+                    threadPool<Accumulator>(*qpool, qpool_arena, data, param, mode, stddev, sum);
+                } else if (scheduler) {
+                    schedulerStats<Accumulator>(*scheduler, data, mode, stddev, sum);
+                } else {
+                    workStealing<Accumulator>(*stealing_pool, data, mode, stddev, sum);
+                }
+                doNotOptimize(mode);
+                doNotOptimize(stddev);
+                doNotOptimize(sum);
+                return true;
+            }, bench.warmup, bench.repetitions, record.summary);
+            if (!allOk(ok)) {
+                return 1;
+            }
+            if (mpi_rank != 0) {
+                continue; // sólo el proceso 0 informa
+            }
+
+            std::string label = scheduler ? strategy + ":" + scheduler->name() : strategy;
+            record.strategy = label;
+            record.param = param;
+            record.threads = num_threads * mpi_size;
+            record.n = total_n;
+            record.grain = adaptive ? plan.grain : static_cast<std::size_t>(grain);
+            record.kernel = active_stats_kernel.name;
+            record.prefetch = stats_prefetch_bytes;
+            record.affinity = affinity.name();
+            record.element = elementName<Element>();
+            record.accumulator = Accumulator::name();
+            record.warmup = bench.warmup;
+            record.repetitions = bench.repetitions;
+            records.push_back(record);
+            warnImplausibleTiming(record);
+            long long min_duration = record.summary.min_ns / 1000;
+
+            std::cout << "Estrategia: " << label << "\n";
+            std::cout << "Hilos: " << num_threads << "\n";
+            if (mpi) {
+                std::cout << "Procesos: " << mpi_size << " (" << num_threads << " hilos cada uno)\n";
+            }
+            if (adaptive) {
+                std::cout << "Plan: " << planName(plan.kind) << ", grano " << plan.grain
+                          << ", previsto " << static_cast<long long>(plan.predicted_ns) << " ns\n";
+            }
+            std::cout << "Núcleo: " << active_stats_kernel.name << "\n";
+            if (stats_prefetch_bytes > 0) {
+                std::cout << "Prefetch: " << stats_prefetch_bytes << " bytes\n";
+            }
+            if (affinity.enabled()) {
+                std::cout << "Afinidad: " << affinity.name() << " (" << affinity.describe(record.threads) << ")\n";
+            }
+            std::cout << "Moda: " << mode << "\n";
+            std::cout << "Desviación estándar: " << stddev << "\n";
+            std::cout << "Suma: " << sum << "\n";
+            if (exact) {
+                std::cout << "Moda exacta: " << exact_stats.mode << " (" << exact_stats.mode_count << " apariciones)\n";
+                std::cout << "Media: " << exact_stats.mean << "\n";
+                std::cout << "Desviación estándar exacta: " << exact_stats.stddev << "\n";
+                std::cout << "Suma exacta: " << exact_stats.sum << "\n";
+            }
+            std::cout << "Tiempo mínimo: " << min_duration << " microsegundos\n";
+            std::cout << "Tiempos (ns): mediana " << record.summary.median_ns
+                      << ", p90 " << record.summary.p90_ns << ", p99 " << record.summary.p99_ns
+                      << ", desviación " << record.summary.stddev_ns << "\n";
+            if (record.summary.allocs_per_call >= 0) {
+                std::cout << "Reservas por llamada: " << record.summary.allocs_per_call << "\n";
+            }
+
+            std::ofstream out("results.csv", std::ios::app);
+            if (out.is_open()) {
+                out << label << "," << num_threads << "," << min_duration << "\n";
+                out.close();
+            } else {
+                std::cerr << "Error: no se pudo abrir results.csv\n";
+            }
+        }
+    }
+
+    // Los runnables de qpool_arena no pueden destruirse con hilos del pool
+    // aún saliendo de run(): la espera ya no la hace waitForDone()
+    qpool->waitForDone();
+
+    if (mpi_rank == 0 && !bench.output.empty() && !writeBenchRecords(bench.output, records)) {
+        return 1;
+    }
+    if (mpi_rank == 0 && !trace_file.empty() && !traceDump(trace_file)) {
+        return 1;
     }
 
     return 0;
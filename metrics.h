@@ -0,0 +1,342 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Métricas en vivo mientras los pools calculan: tiempo ocupado y ocioso por
+// hilo, profundidad de las colas, tareas y elementos calculados, robos y
+// espera en cerrojos. Cada hilo escribe sólo en su propio puesto, con
+// atómicos relajados y sin instrucciones con lock (hay un único escritor por
+// contador), y los puestos se suman al leerlos. Se publican en una línea
+// periódica por stderr (--metrics SEGUNDOS) o en formato Prometheus por HTTP
+// (--metrics-port PUERTO, ruta /metrics). El puerto sólo escucha en
+// 127.0.0.1 salvo que --metrics-bind DIRECCIÓN indique otra interfaz (o
+// 0.0.0.0 para todas). Sin --metrics ni --metrics-port
+// metrics_enabled es false y cada gancho se queda en una comparación.
+
+// Se fija al leer las opciones, antes de crear hilos
+inline bool metrics_enabled = false;
+
+struct alignas(64) MetricsSlot {
+    std::atomic<long long> busy_ns{0};      // dentro de los núcleos de cálculo
+    std::atomic<long long> tasks{0};        // llamadas a los núcleos: una por tarea
+    std::atomic<long long> elements{0};
+    std::atomic<long long> steals{0};
+    std::atomic<long long> lock_wait_ns{0};
+    std::atomic<long long> lifetime_ns{0};  // de los hilos que ya dejaron el puesto
+    std::atomic<long long> since_ns{0};     // inicio del hilo que lo ocupa, 0 = libre
+};
+
+// Suma con un único escritor: carga y almacenamiento relajados
+inline void metricsAdd(std::atomic<long long>& counter, long long delta) {
+    counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+// Lectura de un puesto; idle_ns es el tiempo vivo que no pasó calculando
+struct MetricsSample {
+    bool alive;
+    long long busy_ns, idle_ns, tasks, elements, steals, lock_wait_ns;
+};
+
+// Los puestos de los hilos que terminan se reutilizan, así que los contadores
+// de un puesto sólo crecen aunque los pools se creen de nuevo en cada barrido
+class MetricsRegistry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<MetricsSlot>> slots;
+
+public:
+    const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    std::atomic<long long> queued{0}; // tareas esperando en las colas de los pools
+
+    static MetricsRegistry& instance() {
+        static MetricsRegistry registry;
+        return registry;
+    }
+
+    long long now() const {
+        auto d = std::chrono::steady_clock::now() - epoch;
+        return std::max<long long>(1, std::chrono::duration_cast<std::chrono::nanoseconds>(d).count());
+    }
+
+    MetricsSlot* claim() {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& s : slots) {
+            if (s->since_ns.load(std::memory_order_relaxed) == 0) {
+                s->since_ns.store(now(), std::memory_order_relaxed);
+                return s.get();
+            }
+        }
+        slots.emplace_back(new MetricsSlot);
+        slots.back()->since_ns.store(now(), std::memory_order_relaxed);
+        return slots.back().get();
+    }
+
+    void release(MetricsSlot* slot) {
+        std::lock_guard<std::mutex> lock(mutex);
+        metricsAdd(slot->lifetime_ns, now() - slot->since_ns.load(std::memory_order_relaxed));
+        slot->since_ns.store(0, std::memory_order_relaxed);
+    }
+
+    std::vector<MetricsSample> sample() {
+        std::lock_guard<std::mutex> lock(mutex);
+        long long t = now();
+        std::vector<MetricsSample> out;
+        for (const auto& s : slots) {
+            long long since = s->since_ns.load(std::memory_order_relaxed);
+            long long lifetime = s->lifetime_ns.load(std::memory_order_relaxed) + (since != 0 ? t - since : 0);
+            MetricsSample m;
+            m.alive = since != 0;
+            m.busy_ns = s->busy_ns.load(std::memory_order_relaxed);
+            m.idle_ns = std::max(0LL, lifetime - m.busy_ns);
+            m.tasks = s->tasks.load(std::memory_order_relaxed);
+            m.elements = s->elements.load(std::memory_order_relaxed);
+            m.steals = s->steals.load(std::memory_order_relaxed);
+            m.lock_wait_ns = s->lock_wait_ns.load(std::memory_order_relaxed);
+            out.push_back(m);
+        }
+        return out;
+    }
+};
+
+// Devuelve el puesto al registro cuando el hilo termina
+struct MetricsHandle {
+    MetricsSlot* slot = nullptr;
+
+    ~MetricsHandle() {
+        if (slot) {
+            MetricsRegistry::instance().release(slot);
+        }
+    }
+};
+
+inline MetricsSlot& metricsLocal() {
+    thread_local MetricsHandle handle;
+    if (!handle.slot) {
+        handle.slot = MetricsRegistry::instance().claim();
+    }
+    return *handle.slot;
+}
+
+// Instante para los ganchos siguientes; 0 sin métricas
+inline long long metricsNow() {
+    return metrics_enabled ? MetricsRegistry::instance().now() : 0;
+}
+
+// Un trozo de n elementos calculado desde begin
+inline void metricsKernel(long long begin, std::size_t n) {
+    if (!metrics_enabled) {
+        return;
+    }
+    MetricsSlot& slot = metricsLocal();
+    metricsAdd(slot.busy_ns, MetricsRegistry::instance().now() - begin);
+    metricsAdd(slot.tasks, 1);
+    metricsAdd(slot.elements, static_cast<long long>(n));
+}
+
+// Cerrojo obtenido tras esperar desde before
+inline void metricsLockAcquired(long long before) {
+    if (metrics_enabled) {
+        metricsAdd(metricsLocal().lock_wait_ns, MetricsRegistry::instance().now() - before);
+    }
+}
+
+inline void metricsSteal() {
+    if (metrics_enabled) {
+        metricsAdd(metricsLocal().steals, 1);
+    }
+}
+
+// Tareas que entran (delta > 0) o salen de las colas; aquí escriben varios hilos
+inline void metricsQueued(long long delta) {
+    if (metrics_enabled) {
+        MetricsRegistry::instance().queued.fetch_add(delta, std::memory_order_relaxed);
+    }
+}
+
+// Texto en formato de exposición de Prometheus
+inline std::string metricsPrometheus() {
+    std::vector<MetricsSample> samples = MetricsRegistry::instance().sample();
+    std::ostringstream out;
+    auto counter = [&](const char* name, const char* help, double scale, long long MetricsSample::*field) {
+        out << "# HELP " << name << " " << help << "\n# TYPE " << name << " counter\n";
+        for (std::size_t i = 0; i < samples.size(); ++i) {
+            out << name << "{thread=\"" << i << "\"} ";
+            if (scale == 1) {
+                out << samples[i].*field << "\n";
+            } else {
+                out << samples[i].*field * scale << "\n";
+            }
+        }
+    };
+    counter("stats_busy_seconds_total", "Tiempo calculando por hilo", 1e-9, &MetricsSample::busy_ns);
+    counter("stats_idle_seconds_total", "Tiempo vivo sin calcular por hilo", 1e-9, &MetricsSample::idle_ns);
+    counter("stats_tasks_total", "Trozos calculados por hilo", 1, &MetricsSample::tasks);
+    counter("stats_elements_total", "Elementos calculados por hilo", 1, &MetricsSample::elements);
+    counter("stats_steals_total", "Tareas robadas por hilo", 1, &MetricsSample::steals);
+    counter("stats_lock_wait_seconds_total", "Espera en cerrojos de los pools por hilo", 1e-9,
+            &MetricsSample::lock_wait_ns);
+    out << "# HELP stats_queue_depth Tareas esperando en las colas de los pools\n"
+        << "# TYPE stats_queue_depth gauge\n"
+        << "stats_queue_depth " << MetricsRegistry::instance().queued.load(std::memory_order_relaxed) << "\n";
+    return out.str();
+}
+
+// Interfaz del puerto de métricas sin --metrics-bind: sólo la propia máquina
+const char* const DEFAULT_METRICS_BIND = "127.0.0.1";
+
+// Hilo que escribe la línea periódica y atiende el puerto HTTP. Se detiene
+// al destruirse, a través de una tubería que despierta su poll().
+class MetricsReporter {
+    std::thread thread;
+    int listen_fd = -1;
+    int wake[2] = {-1, -1};
+    int interval_s = 0;
+
+    std::vector<MetricsSample> previous;
+    long long previous_ns = 0;
+
+    void logLine() {
+        std::vector<MetricsSample> samples = MetricsRegistry::instance().sample();
+        long long t = MetricsRegistry::instance().now();
+        double seconds = (t - previous_ns) * 1e-9;
+        long long tasks = 0, elements = 0, steals = 0, lock_wait_ns = 0;
+        std::ostringstream busy;
+        for (std::size_t i = 0; i < samples.size(); ++i) {
+            MetricsSample before = i < previous.size() ? previous[i] : MetricsSample{false, 0, 0, 0, 0, 0, 0};
+            tasks += samples[i].tasks - before.tasks;
+            elements += samples[i].elements - before.elements;
+            steals += samples[i].steals - before.steals;
+            lock_wait_ns += samples[i].lock_wait_ns - before.lock_wait_ns;
+            if (samples[i].alive) {
+                // Un trozo se anota al terminar, así que puede cubrir más de un periodo
+                double share = std::min(1.0, (samples[i].busy_ns - before.busy_ns) * 1e-9 / seconds);
+                busy << (busy.tellp() > 0 ? "," : "") << "h" << i << ":" << static_cast<int>(100 * share + 0.5) << "%";
+            }
+        }
+        std::ostringstream line;
+        line << "[métricas] tareas/s=" << tasks / seconds << " elementos/s=" << elements / seconds
+             << " cola=" << MetricsRegistry::instance().queued.load(std::memory_order_relaxed)
+             << " robos=" << steals << " espera_cerrojos_ms=" << lock_wait_ns * 1e-6
+             << " ocupación=" << busy.str() << "\n";
+        std::cerr << line.str();
+        previous = samples;
+        previous_ns = t;
+    }
+
+    void serveOne() {
+        int fd = accept(listen_fd, nullptr, nullptr);
+        if (fd < 0) {
+            return;
+        }
+        char request[1024];
+        pollfd client = {fd, POLLIN, 0};
+        ssize_t got = poll(&client, 1, 1000) > 0 ? recv(fd, request, sizeof(request) - 1, 0) : -1;
+        bool found = got > 0 && std::strncmp(request, "GET /metrics", 12) == 0;
+        std::string body = found ? metricsPrometheus() : "no encontrado\n";
+        std::string response = std::string(found ? "HTTP/1.0 200 OK" : "HTTP/1.0 404 Not Found") +
+                               "\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: " +
+                               std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+        for (std::size_t sent = 0; sent < response.size();) {
+            ssize_t n = send(fd, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) {
+                break;
+            }
+            sent += static_cast<std::size_t>(n);
+        }
+        close(fd);
+    }
+
+    void loop() {
+        previous_ns = MetricsRegistry::instance().now();
+        long long next = previous_ns + interval_s * 1000000000LL;
+        for (;;) {
+            int timeout = -1;
+            if (interval_s > 0) {
+                timeout = static_cast<int>(std::max(0LL, (next - MetricsRegistry::instance().now()) / 1000000));
+            }
+            pollfd fds[2] = {{wake[0], POLLIN, 0}, {listen_fd, POLLIN, 0}}; // poll ignora un fd negativo
+            poll(fds, 2, timeout);
+            if (fds[0].revents) {
+                return;
+            }
+            if (fds[1].revents & POLLIN) {
+                serveOne();
+            }
+            if (interval_s > 0 && MetricsRegistry::instance().now() >= next) {
+                logLine();
+                next += interval_s * 1000000000LL;
+            }
+        }
+    }
+
+public:
+    MetricsReporter() = default;
+    MetricsReporter(const MetricsReporter&) = delete;
+    MetricsReporter& operator=(const MetricsReporter&) = delete;
+
+    ~MetricsReporter() {
+        if (thread.joinable()) {
+            char stop = 0;
+            if (write(wake[1], &stop, 1) == 1) {
+                thread.join();
+            } else {
+                thread.detach();
+            }
+        }
+        for (int fd : {listen_fd, wake[0], wake[1]}) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+    }
+
+    // interval en segundos (0 = sin línea periódica), port < 0 = sin HTTP,
+    // bind es la dirección IPv4 de la interfaz en la que escuchar
+    bool start(int interval, int port, const std::string& bind_address) {
+        interval_s = interval;
+        if (port >= 0) {
+            listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+            int reuse = 1;
+            setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+            sockaddr_in addr;
+            std::memset(&addr, 0, sizeof(addr));
+            addr.sin_family = AF_INET;
+            if (inet_pton(AF_INET, bind_address.c_str(), &addr.sin_addr) != 1) {
+                std::cerr << "Error: --metrics-bind espera una dirección IPv4, no " << bind_address << "\n";
+                return false;
+            }
+            addr.sin_port = htons(static_cast<unsigned short>(port));
+            if (listen_fd < 0 || bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+                listen(listen_fd, 8) != 0) {
+                std::cerr << "Error: no se pudo escuchar en " << bind_address << ":" << port << ": " << std::strerror(errno)
+                          << "\n";
+                return false;
+            }
+        }
+        if (pipe(wake) != 0) {
+            std::cerr << "Error: no se pudo crear la tubería de las métricas\n";
+            return false;
+        }
+        thread = std::thread(&MetricsReporter::loop, this);
+        return true;
+    }
+};
+
+#endif // METRICS_H
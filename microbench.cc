@@ -0,0 +1,269 @@
+#include <benchmark/benchmark.h>
+#include <QRunnable>
+#include <QThreadPool>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "affinity.h"
+#include "benchmark.h"
+#include "dataset.h"
+#include "scheduler.h"
+#include "stats_kernel.h"
+#include "stats_partial.h"
+#include "stats_types.h"
+#include "worker_pool.h"
+
+// Microbenchmarks con Google Benchmark (qmake CONFIG+=gbench, ver bench.sh):
+// cada pieza del camino caliente por separado, para que una regresión se vea
+// en la pieza que la causa y no sólo en el tiempo total de main().
+//   Kernel/<núcleo>/n       computeMetrics por elemento en cada núcleo
+//   Dispatch<backend>/tasks coste de lanzar una tarea vacía
+//   Reduce<Mutex|Slots>     combinar parciales con mutex o por puesto
+//   Scaling/n/threads       extremo a extremo con ThreadScheduler
+// Además de las opciones --benchmark_* acepta --max-n=N (1e8 por defecto,
+// 1e9 necesita 8 GB con double) y --max-threads=T (64 por defecto).
+
+static const std::uint64_t BENCH_SEED = 42;
+
+static std::size_t bench_max_n = 100000000;
+static int bench_max_threads = 64;
+
+// Datos generados una vez con el tamaño mayor; cada benchmark usa un prefijo
+static DataSpan<Element> benchData(std::size_t n) {
+    static GeneratedData generated;
+    static std::size_t generated_n = 0;
+    if (generated_n < n) {
+        generated.generate(n, BENCH_SEED);
+        generated_n = n;
+    }
+    DataSpan<Element> data = generated.span();
+    data.count = n;
+    return data;
+}
+
+static void setKernel(benchmark::State& state, const char* name) {
+    if (!selectStatsKernel(name, Accumulator::vectorizable)) {
+        state.SkipWithError("núcleo no disponible");
+    }
+}
+
+// computeMetrics sobre un trozo del tamaño de L1, L2, L3 y memoria
+static void kernelBench(benchmark::State& state, const char* name) {
+    setKernel(state, name);
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    DataSpan<Element> data = benchData(n);
+    for (auto _ : state) {
+        StatsPartial<Accumulator> partial;
+        runStatsKernel(data.ptr, 0, n, 0, partial);
+        benchmark::DoNotOptimize(partial);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<long long>(n));
+    state.SetBytesProcessed(state.iterations() * static_cast<long long>(n * sizeof(Element)));
+}
+
+// Tarea vacía: sólo cuesta repartirla y esperarla
+class NoopRunnable : public QRunnable {
+public:
+    NoopRunnable() {
+        setAutoDelete(false);
+    }
+
+    void run() override {}
+};
+
+// Un hilo nuevo por tarea, como la primera versión del programa
+static void BM_DispatchThread(benchmark::State& state) {
+    int tasks = static_cast<int>(state.range(0));
+    std::vector<std::thread> threads;
+    threads.reserve(tasks);
+    for (auto _ : state) {
+        for (int i = 0; i < tasks; ++i) {
+            threads.emplace_back([] {});
+        }
+        for (std::thread& t : threads) {
+            t.join();
+        }
+        threads.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * tasks);
+}
+
+// QThreadPool con los hilos ya creados, como la estrategia -p
+static void BM_DispatchQThreadPool(benchmark::State& state) {
+    int tasks = static_cast<int>(state.range(0));
+    QThreadPool pool;
+    pool.setMaxThreadCount(tasks);
+    std::vector<NoopRunnable> noops(tasks);
+    for (NoopRunnable& r : noops) {
+        pool.start(&r);
+    }
+    pool.waitForDone();
+    for (auto _ : state) {
+        for (NoopRunnable& r : noops) {
+            pool.start(&r);
+        }
+        pool.waitForDone();
+    }
+    state.SetItemsProcessed(state.iterations() * tasks);
+}
+
+// WorkerPool persistente, el de DivideConquer
+static void BM_DispatchWorkerPool(benchmark::State& state) {
+    int tasks = static_cast<int>(state.range(0));
+    WorkerPool pool(tasks);
+    for (auto _ : state) {
+        for (int i = 0; i < tasks; ++i) {
+            pool.submit([] {});
+        }
+        pool.wait();
+    }
+    state.SetItemsProcessed(state.iterations() * tasks);
+}
+
+// Reducción con trozos pequeños y muchas tareas, para que pese el combinar
+// y no el cálculo. range(0) = tareas, range(1) = hilos del pool.
+const std::size_t REDUCE_ELEMS = 1 << 16;
+
+// Cada tarea suma su parcial a un total compartido bajo un mutex
+static void BM_ReduceMutex(benchmark::State& state) {
+    selectStatsKernel("auto", Accumulator::vectorizable);
+    int tasks = static_cast<int>(state.range(0));
+    WorkerPool pool(static_cast<int>(state.range(1)));
+    DataSpan<Element> data = benchData(REDUCE_ELEMS);
+    std::mutex mutex;
+    for (auto _ : state) {
+        StatsPartial<Accumulator> total;
+        for (int i = 0; i < tasks; ++i) {
+            pool.submit([&total, &mutex, data, tasks, i] {
+                StatsPartial<Accumulator> local;
+                runStatsKernel(data.ptr, data.size() * i / tasks, data.size() * (i + 1) / tasks, 0, local);
+                std::lock_guard<std::mutex> lock(mutex);
+                total.merge(local);
+            });
+        }
+        pool.wait();
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * tasks);
+}
+
+// Cada tarea escribe en su puesto y se reducen al final, como las estrategias
+static void BM_ReduceSlots(benchmark::State& state) {
+    selectStatsKernel("auto", Accumulator::vectorizable);
+    int tasks = static_cast<int>(state.range(0));
+    WorkerPool pool(static_cast<int>(state.range(1)));
+    DataSpan<Element> data = benchData(REDUCE_ELEMS);
+    std::vector<StatsPartial<Accumulator>> partials(tasks);
+    for (auto _ : state) {
+        StatsPartial<Accumulator>* slots = partials.data();
+        for (int i = 0; i < tasks; ++i) {
+            slots[i] = StatsPartial<Accumulator>();
+            pool.submit([slots, data, tasks, i] {
+                runStatsKernel(data.ptr, data.size() * i / tasks, data.size() * (i + 1) / tasks, 0, slots[i]);
+            });
+        }
+        pool.wait();
+        StatsPartial<Accumulator> total = reducePartials(partials);
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * tasks);
+}
+
+// Extremo a extremo: troceado, reparto, cálculo, reducción y finalizeStats
+static void BM_Scaling(benchmark::State& state) {
+    selectStatsKernel("auto", Accumulator::vectorizable);
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    int threads = static_cast<int>(state.range(1));
+    DataSpan<Element> data = benchData(n);
+    ThreadScheduler scheduler(threads, AffinityPolicy());
+    double mode = 0, stddev = 0;
+    ProductValue sum;
+    for (auto _ : state) {
+        schedulerStats<Accumulator>(scheduler, data, mode, stddev, sum);
+        benchmark::DoNotOptimize(mode);
+        benchmark::DoNotOptimize(stddev);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<long long>(n));
+}
+
+// Potencias de dos de 1 a max, con max siempre incluido
+static std::vector<std::int64_t> threadCounts(int max) {
+    std::vector<std::int64_t> counts;
+    for (std::int64_t t = 1; t < max; t *= 2) {
+        counts.push_back(t);
+    }
+    counts.push_back(max);
+    return counts;
+}
+
+static void registerBenchmarks() {
+    std::vector<std::int64_t> threads = threadCounts(bench_max_threads);
+
+    static const char* const kernels[] = {"scalar", "avx2", "avx512", "neon"};
+    for (const char* name : kernels) {
+        if (!selectStatsKernel(name, Accumulator::vectorizable)) {
+            continue;
+        }
+        benchmark::RegisterBenchmark((std::string("Kernel/") + name).c_str(), kernelBench, name)
+            ->ArgName("n")->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+    }
+
+    benchmark::RegisterBenchmark("DispatchThread", BM_DispatchThread)->ArgName("tasks")->ArgsProduct({threads})->UseRealTime();
+    benchmark::RegisterBenchmark("DispatchQThreadPool", BM_DispatchQThreadPool)->ArgName("tasks")->ArgsProduct({threads})->UseRealTime();
+    benchmark::RegisterBenchmark("DispatchWorkerPool", BM_DispatchWorkerPool)->ArgName("tasks")->ArgsProduct({threads})->UseRealTime();
+
+    std::vector<std::int64_t> reduce_tasks = {16, 256, 4096};
+    std::int64_t reduce_threads = std::min<std::int64_t>(bench_max_threads, std::max(1u, std::thread::hardware_concurrency()));
+    benchmark::RegisterBenchmark("ReduceMutex", BM_ReduceMutex)
+        ->ArgNames({"tasks", "threads"})->ArgsProduct({reduce_tasks, {reduce_threads}})->UseRealTime();
+    benchmark::RegisterBenchmark("ReduceSlots", BM_ReduceSlots)
+        ->ArgNames({"tasks", "threads"})->ArgsProduct({reduce_tasks, {reduce_threads}})->UseRealTime();
+
+    std::vector<std::int64_t> sizes;
+    for (std::int64_t n = 100; n <= static_cast<std::int64_t>(bench_max_n); n *= 10) {
+        sizes.push_back(n);
+    }
+    benchmark::RegisterBenchmark("Scaling", BM_Scaling)
+        ->ArgNames({"n", "threads"})->ArgsProduct({sizes, threads})->UseRealTime()->Unit(benchmark::kMicrosecond);
+
+    selectStatsKernel("auto", Accumulator::vectorizable);
+}
+
+int main(int argc, char* argv[]) {
+    benchmark::Initialize(&argc, argv);
+
+    // Opciones propias; Initialize ya ha quitado las --benchmark_*
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--max-n=", 8) == 0) {
+            double value = std::strtod(argv[i] + 8, nullptr); // admite 1e9
+            if (value < 100) {
+                std::cerr << "Error: --max-n debe ser al menos 100\n";
+                return 1;
+            }
+            bench_max_n = static_cast<std::size_t>(value);
+        } else if (std::strncmp(argv[i], "--max-threads=", 14) == 0) {
+            bench_max_threads = std::atoi(argv[i] + 14);
+            if (bench_max_threads < 1) {
+                std::cerr << "Error: --max-threads debe ser al menos 1\n";
+                return 1;
+            }
+        } else {
+            std::cerr << "Error: opción inválida " << argv[i]
+                      << ", use [--benchmark_*] [--max-n=N] [--max-threads=T]\n";
+            return 1;
+        }
+    }
+
+    registerBenchmarks();
+    benchmark::AddCustomContext("element", elementName<Element>());
+    benchmark::AddCustomContext("accumulator", Accumulator::name());
+    benchmark::AddCustomContext("compiler", compilerName());
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
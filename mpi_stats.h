@@ -0,0 +1,99 @@
+#ifndef MPI_STATS_H
+#define MPI_STATS_H
+
+#ifdef STATS_WITH_MPI
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <mpi.h>
+#include "dataset.h"
+#include "stats_partial.h"
+
+// Modo distribuido (--mpi): cada proceso calcula con su pool local la parte
+// de los datos que le toca y los parciales se combinan entre procesos. Todos
+// reciben los parciales de todos (MPI_Allgather) y los reducen en el mismo
+// orden con reducePartials, de modo que el resultado es el mismo en cada
+// proceso y no depende de cómo MPI agrupe los mensajes. Sólo el hilo
+// principal llama a MPI.
+
+// Inicia MPI y lo cierra al salir del ámbito, también en las salidas por error
+class MpiSession {
+    int process_rank = 0;
+    int process_count = 1;
+
+public:
+    MpiSession(int* argc, char*** argv) {
+        int provided;
+        MPI_Init_thread(argc, argv, MPI_THREAD_FUNNELED, &provided);
+        MPI_Comm_rank(MPI_COMM_WORLD, &process_rank);
+        MPI_Comm_size(MPI_COMM_WORLD, &process_count);
+    }
+
+    ~MpiSession() { MPI_Finalize(); }
+
+    MpiSession(const MpiSession&) = delete;
+    MpiSession& operator=(const MpiSession&) = delete;
+
+    int rank() const { return process_rank; }
+    int size() const { return process_count; }
+};
+
+// Parte [first, first + count) de total elementos que toca al proceso rank
+inline void mpiShard(std::size_t total, int rank, int ranks, std::size_t& first, std::size_t& count) {
+    first = total / ranks * rank + std::min<std::size_t>(total % ranks, rank);
+    count = total / ranks + (static_cast<std::size_t>(rank) < total % ranks ? 1 : 0);
+}
+
+// Como loadDataset, pero data es sólo la parte de este proceso, first su
+// índice global y total el número de elementos entre todos. Los valores
+// generados se crean sólo para esa parte; un fichero se proyecta entero y
+// cada proceso lee únicamente sus páginas.
+inline bool mpiLoadShard(const MpiSession& mpi, const std::string& file, std::size_t n, std::uint64_t seed,
+                         GeneratedData& generated, MappedFile& mapped, DataSpan<Element>& data,
+                         std::size_t& first, std::size_t& total) {
+    std::size_t count;
+    if (file.empty() && n > 0) {
+        total = n;
+        mpiShard(n, mpi.rank(), mpi.size(), first, count);
+        generated.generate(count, seed, first);
+        data = generated.span();
+        return true;
+    }
+    DataSpan<Element> all;
+    if (!loadDataset(file, n, seed, generated, mapped, all)) {
+        return false;
+    }
+    total = all.size();
+    mpiShard(total, mpi.rank(), mpi.size(), first, count);
+    data.ptr = all.ptr + first;
+    data.count = count;
+    return true;
+}
+
+// true si ok es true en todos los procesos. Un proceso que falla antes de
+// una operación colectiva tiene que avisar a los demás, o éstos esperarían
+// para siempre en ella: todos salen juntos.
+inline bool mpiAllOk(const MpiSession&, bool ok) {
+    int local = ok ? 1 : 0, all = 0;
+    MPI_Allreduce(&local, &all, 1, MPI_INT, MPI_LAND, MPI_COMM_WORLD);
+    return all != 0;
+}
+
+// Combina el parcial de cada proceso; gathered se reutiliza entre llamadas
+template <typename Acc>
+StatsPartial<Acc> mpiReducePartials(const MpiSession& mpi, const StatsPartial<Acc>& local,
+                                    std::vector<StatsPartial<Acc>>& gathered) {
+    static_assert(std::is_trivially_copyable<StatsPartial<Acc>>::value,
+                  "los parciales se envían como bytes");
+    gathered.resize(mpi.size());
+    MPI_Allgather(&local, sizeof(local), MPI_BYTE, gathered.data(), sizeof(local), MPI_BYTE, MPI_COMM_WORLD);
+    return reducePartials(gathered);
+}
+
+#endif // STATS_WITH_MPI
+
+#endif // MPI_STATS_H
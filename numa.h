@@ -0,0 +1,168 @@
+#ifndef NUMA_H
+#define NUMA_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sched.h>
+#include "affinity.h"
+#include "benchmark.h"
+#include "chunking.h"
+#include "dataset.h"
+#include "stats_partial.h"
+#include "stats_task.h"
+#include "worker_pool.h"
+
+// Modo NUMA: cada worker se fija a las CPUs de un nodo, toca primero (genera
+// o copia) su trozo de datos para que las páginas queden en ese nodo y luego
+// calcula exactamente ese mismo trozo. La topología se lee de /sys, sin libnuma.
+
+struct NumaNode {
+    int id = 0;
+    std::vector<int> cpus;
+};
+
+// Nodos con CPUs permitidas para el proceso (respeta --pin). Si /sys no
+// expone la topología se devuelve un único nodo con todas las CPUs.
+inline std::vector<NumaNode> numaNodes() {
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    bool have_mask = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+
+    std::vector<NumaNode> nodes;
+    std::string text;
+    std::vector<long long> ids, cpus;
+    std::ifstream online("/sys/devices/system/node/online");
+    if (online >> text && parseList(text, ids)) {
+        for (long long id : ids) {
+            std::ifstream in("/sys/devices/system/node/node" + std::to_string(id) + "/cpulist");
+            if (!(in >> text) || !parseList(text, cpus)) {
+                continue; // nodo sólo de memoria
+            }
+            NumaNode node;
+            node.id = static_cast<int>(id);
+            for (long long cpu : cpus) {
+                if (cpu < CPU_SETSIZE && (!have_mask || CPU_ISSET(cpu, &allowed))) {
+                    node.cpus.push_back(static_cast<int>(cpu));
+                }
+            }
+            if (!node.cpus.empty()) {
+                nodes.push_back(node);
+            }
+        }
+    }
+
+    if (nodes.empty()) {
+        NumaNode node;
+        int cores = std::max(1u, std::thread::hardware_concurrency());
+        for (int cpu = 0; cpu < cores; ++cpu) {
+            if (!have_mask || CPU_ISSET(cpu, &allowed)) {
+                node.cpus.push_back(cpu);
+            }
+        }
+        nodes.push_back(node);
+    }
+    return nodes;
+}
+
+// Reparto de los workers entre nodos en bloques consecutivos, de modo que
+// trozos de datos contiguos caen en el mismo nodo
+struct NumaLayout {
+    std::vector<NumaNode> nodes;
+    std::vector<int> worker_node;
+};
+
+inline NumaLayout numaLayout(int num_workers) {
+    NumaLayout layout;
+    layout.nodes = numaNodes();
+    int num_nodes = static_cast<int>(layout.nodes.size());
+    for (int w = 0; w < num_workers; ++w) {
+        layout.worker_node.push_back(static_cast<int>(static_cast<long long>(w) * num_nodes / num_workers));
+    }
+    return layout;
+}
+
+// Pool cuyos workers se fijan a su nodo al arrancar, antes de tocar datos
+inline std::unique_ptr<WorkerPool> makeNumaPool(int num_workers) {
+    NumaLayout layout = numaLayout(num_workers);
+    return std::unique_ptr<WorkerPool>(new WorkerPool(num_workers, [layout](int w) {
+        pinCurrentThread(layout.nodes[layout.worker_node[w]].cpus);
+    }));
+}
+
+// Ejecuta fill(start, end) en el worker dueño de cada trozo de data[0, n) y
+// espera. Las fronteras se alinean a página para que ninguna página quede
+// compartida entre dos nodos.
+template <typename T, typename F>
+void numaForEachChunk(WorkerPool& pool, const T* data, std::size_t n, F fill) {
+    int parts = pool.size();
+    if (parts == 0) {
+        fill(std::size_t(0), n);
+        return;
+    }
+    for (int w = 0; w < parts; ++w) {
+        std::size_t start = chunkBoundary(data, n, parts, w, PAGE_BYTES);
+        std::size_t end = chunkBoundary(data, n, parts, w + 1, PAGE_BYTES);
+        pool.submitTo(w, [&fill, start, end] { fill(start, end); });
+    }
+    pool.wait();
+}
+
+// Como loadDataset, pero los datos generados o copiados del fichero los
+// escribe por primera vez el worker que después los procesará. file es el
+// fichero ya proyectado (nullptr si no hay): se abre una vez por tamaño, y
+// con cada pool sólo se repite la copia, que es lo que coloca las páginas.
+inline void numaLoadDataset(WorkerPool& pool, const MappedFile* file, std::size_t n, std::uint64_t seed,
+                            GeneratedData& generated, DataSpan<Element>& data) {
+    if (file) {
+        DataSpan<Element> src = file->span();
+        Element* out = generated.allocate(src.size());
+        numaForEachChunk(pool, out, src.size(), [out, src](std::size_t start, std::size_t end) {
+            std::memcpy(out + start, src.ptr + start, (end - start) * sizeof(Element));
+        });
+    } else if (n > 0) {
+        Element* out = generated.allocate(n);
+        numaForEachChunk(pool, out, n, [out, seed](std::size_t start, std::size_t end) {
+            fillGenerated(out, seed, start, end);
+        });
+    } else {
+        generated.legacy();
+    }
+    data = generated.span();
+}
+
+// Cada worker calcula el trozo que tocó en numaLoadDataset
+template <typename Acc, typename T>
+void numaStats(WorkerPool& pool, DataSpan<T> data, double& mode, double& stddev, ProductValue& sum) {
+    int parts = std::max(1, pool.size());
+    pool.arena().reset();
+    StatsPartial<Acc>* partials = pool.arena().allocate<StatsPartial<Acc>>(parts);
+    StatsTask<T, Acc>* tasks = pool.arena().allocate<StatsTask<T, Acc>>(parts);
+    for (int w = 0; w < parts; ++w) {
+        std::size_t start = chunkBoundary(data.ptr, data.size(), parts, w, PAGE_BYTES);
+        std::size_t end = chunkBoundary(data.ptr, data.size(), parts, w + 1, PAGE_BYTES);
+        new (&partials[w]) StatsPartial<Acc>();
+        new (&tasks[w]) StatsTask<T, Acc>(data, start, end, partials[w]);
+    }
+
+    if (pool.size() == 0) {
+        tasks[0].computeMetrics();
+    } else {
+        for (int w = 0; w < parts; ++w) {
+            StatsTask<T, Acc>* task = &tasks[w];
+            task->markEnqueued();
+            pool.submitTo(w, [task] { task->computeMetrics(); });
+        }
+        pool.wait();
+    }
+
+    finalizeStats(reducePartials(partials, parts), mode, stddev, sum);
+}
+
+#endif // NUMA_H
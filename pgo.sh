@@ -0,0 +1,30 @@
+#!/bin/sh
+# Compilación guiada por perfil: compila instrumentado, entrena con el
+# barrido de benchmark de las estrategias y recompila con los perfiles.
+# Uso: ./pgo.sh [DIRECTORIO_DE_COMPILACIÓN]   (QMAKE=qmake6 para Qt 6)
+set -e
+SRC=$(cd "$(dirname "$0")" && pwd)
+BUILD=${1:-build-pgo}
+QMAKE=${QMAKE:-qmake}
+JOBS=$(nproc 2>/dev/null || echo 2)
+
+mkdir -p "$BUILD"
+cd "$BUILD"
+PGO_DIR="$(pwd)/pgo-data"
+rm -rf "$PGO_DIR"
+
+$QMAKE "$SRC/qthreadpool.pro" CONFIG+=pgo_gen PGO_DIR="$PGO_DIR"
+make -j"$JOBS"
+
+# Entrenamiento: los mismos barridos que se publican, sin guardar resultados
+SIZES=1000,100000,10000000
+./stats --sweep 0-5 --sizes $SIZES --reps 3 > /dev/null
+./stats_pool -d 0 --sweep 0-5 --sizes $SIZES --reps 3 > /dev/null
+./stats_pool -p 1 --sweep 1,2,4,8,16 --sizes $SIZES --reps 3 > /dev/null
+./stats_pool -w 1 --sweep 1,2,4,8,16 --sizes $SIZES --reps 3 > /dev/null
+rm -f results.csv
+
+make distclean
+$QMAKE "$SRC/qthreadpool.pro" CONFIG+=pgo_use PGO_DIR="$PGO_DIR"
+make -j"$JOBS"
+echo "Binarios con PGO en $(pwd): stats, stats_pool"
@@ -1,4 +1,12 @@
-QT += core
-CONFIG += c++17
-SOURCES += main.cc
-TARGET = stats
+# Un ejecutable por fichero principal: qmake && make construye los dos en
+# Release (ver common.pri para las opciones de compilación)
+TEMPLATE = subdirs
+SUBDIRS = stats stats_pool
+stats.file = stats.pro
+stats_pool.file = stats_pool.pro
+
+# qmake CONFIG+=gbench: añade stats_bench (microbench.cc, ver bench.sh)
+gbench {
+    SUBDIRS += stats_bench
+    stats_bench.file = stats_bench.pro
+}
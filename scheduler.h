@@ -0,0 +1,208 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "affinity.h"
+#include "chunking.h"
+#include "dataset.h"
+#include "latch.h"
+#include "stats_partial.h"
+#include "stats_task.h"
+#include "task_arena.h"
+#include "work_stealing.h"
+#include "worker_pool.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#ifdef STATS_WITH_PSTL
+#include <algorithm>
+#include <execution>
+#endif
+
+// Planificadores intercambiables: todos reciben los mismos trozos (ver
+// schedulerStats) y sólo cambia cómo se reparten, de modo que al compararlos
+// en el mismo binario se mide únicamente el coste del reparto. El de
+// QThreadPool está en maincontodo.cc, el único que enlaza con Qt.
+class TaskScheduler {
+    TaskArena task_arena;
+
+public:
+    virtual ~TaskScheduler() = default;
+
+    virtual const char* name() const = 0;
+
+    // Hilos que calculan, el llamante incluido si participa
+    virtual int threads() const = 0;
+
+    // Ejecuta f(0) ... f(parts - 1) y bloquea hasta que terminen todas
+    virtual void parallelFor(int parts, const std::function<void(int)>& f) = 0;
+
+    // Memoria para las tareas de una llamada
+    TaskArena& arena() { return task_arena; }
+};
+
+// Fork/join sobre std::thread: el llamante hace la parte 0, ayuda con las
+// pendientes y espera el resto en un CompletionLatch
+class ThreadScheduler : public TaskScheduler {
+    WorkerPool pool;
+    CompletionLatch remaining;
+    const std::function<void(int)>* job = nullptr; // así cada tarea cabe en una std::function sin reservar
+
+public:
+    ThreadScheduler(int num_threads, const AffinityPolicy& affinity)
+        : pool(num_threads - 1, affinity.workerStart()) {}
+
+    const char* name() const override { return "threads"; }
+    int threads() const override { return pool.size() + 1; }
+
+    void parallelFor(int parts, const std::function<void(int)>& f) override {
+        job = &f;
+        remaining.reset(parts > 0 ? parts - 1 : 0);
+        for (int i = 1; i < parts; ++i) {
+            pool.submit([this, i] {
+                (*job)(i);
+                remaining.countDown();
+            });
+        }
+        if (parts > 0) {
+            f(0);
+        }
+        while (pool.runPendingTask()) {
+        }
+        remaining.wait();
+    }
+};
+
+// Colas por worker con robo (ver work_stealing.h); el llamante sólo espera
+class StealingScheduler : public TaskScheduler {
+    WorkStealingPool pool;
+
+public:
+    StealingScheduler(int num_threads, const AffinityPolicy& affinity)
+        : pool(num_threads, affinity.workerStart()) {}
+
+    const char* name() const override { return "stealing"; }
+    int threads() const override { return pool.size(); }
+
+    void parallelFor(int parts, const std::function<void(int)>& f) override {
+        pool.run(parts, std::ref(f));
+    }
+};
+
+#ifdef _OPENMP
+// Bucle OpenMP con reparto estático; el llamante es el hilo 0 del equipo
+class OpenMpScheduler : public TaskScheduler {
+    int num_threads;
+
+public:
+    OpenMpScheduler(int n, const AffinityPolicy& affinity) : num_threads(n) {
+        // libgomp reutiliza el mismo equipo en cada región paralela, así que
+        // basta con fijar la afinidad una vez
+#pragma omp parallel num_threads(num_threads)
+        affinity.pinSlot(omp_get_thread_num());
+    }
+
+    const char* name() const override { return "openmp"; }
+    int threads() const override { return num_threads; }
+
+    void parallelFor(int parts, const std::function<void(int)>& f) override {
+#pragma omp parallel for num_threads(num_threads) schedule(static)
+        for (int i = 0; i < parts; ++i) {
+            f(i);
+        }
+    }
+};
+#endif
+
+#ifdef STATS_WITH_PSTL
+// Algoritmo paralelo de la biblioteca estándar (TBB por debajo en GCC). Sus
+// hilos no se pueden dimensionar ni fijar: num_threads sólo decide los trozos.
+class PstlScheduler : public TaskScheduler {
+    int num_threads;
+    std::vector<int> indices;
+
+public:
+    explicit PstlScheduler(int n) : num_threads(n) {}
+
+    const char* name() const override { return "pstl"; }
+    int threads() const override { return num_threads; }
+
+    void parallelFor(int parts, const std::function<void(int)>& f) override {
+        for (int i = static_cast<int>(indices.size()); i < parts; ++i) {
+            indices.push_back(i);
+        }
+        std::for_each(std::execution::par, indices.begin(), indices.begin() + parts, f);
+    }
+};
+#endif
+
+// Nombres de los planificadores compilados, separados por comas
+inline std::string schedulerNames() {
+    std::string names = "threads,stealing";
+#ifdef _OPENMP
+    names += ",openmp";
+#endif
+#ifdef STATS_WITH_PSTL
+    names += ",pstl";
+#endif
+    return names;
+}
+
+// Crea el planificador por nombre; nullptr si no existe o no se ha compilado
+inline std::unique_ptr<TaskScheduler> makeScheduler(const std::string& name, int num_threads,
+                                                    const AffinityPolicy& affinity) {
+    if (name == "threads") {
+        return std::unique_ptr<TaskScheduler>(new ThreadScheduler(num_threads, affinity));
+    }
+    if (name == "stealing") {
+        return std::unique_ptr<TaskScheduler>(new StealingScheduler(num_threads, affinity));
+    }
+#ifdef _OPENMP
+    if (name == "openmp") {
+        return std::unique_ptr<TaskScheduler>(new OpenMpScheduler(num_threads, affinity));
+    }
+#endif
+#ifdef STATS_WITH_PSTL
+    if (name == "pstl") {
+        return std::unique_ptr<TaskScheduler>(new PstlScheduler(num_threads));
+    }
+#endif
+    return nullptr;
+}
+
+// Scheduler strategy: el troceado y la reducción de siempre (chunking.h,
+// reducePartials) con el reparto delegado en el planificador
+template <typename Acc, typename T>
+void schedulerStats(TaskScheduler& scheduler, DataSpan<T> data, double& mode, double& stddev, ProductValue& sum) {
+    if (data.empty()) {
+        mode = 0;
+        stddev = 0;
+        sum = ProductValue();
+        return;
+    }
+
+    std::size_t size = data.size();
+    int num_tasks = static_cast<int>(chunkCount(size, scheduler.threads()));
+    scheduler.arena().reset();
+    StatsPartial<Acc>* partials = scheduler.arena().allocate<StatsPartial<Acc>>(num_tasks);
+    StatsTask<T, Acc>* tasks = scheduler.arena().allocate<StatsTask<T, Acc>>(num_tasks);
+    for (int i = 0; i < num_tasks; ++i) {
+        std::size_t start = chunkBoundary(data.ptr, size, num_tasks, i);
+        std::size_t end = chunkBoundary(data.ptr, size, num_tasks, i + 1);
+        new (&partials[i]) StatsPartial<Acc>();
+        new (&tasks[i]) StatsTask<T, Acc>(data, start, end, partials[i]);
+        tasks[i].markEnqueued();
+    }
+
+    long long begin = traceNow();
+    scheduler.parallelFor(num_tasks, [tasks](int t) { tasks[t].computeMetrics(); });
+    traceSpan(scheduler.name(), begin);
+
+    finalizeStats(reducePartials(partials, num_tasks), mode, stddev, sum);
+}
+
+#endif // SCHEDULER_H
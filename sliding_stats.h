@@ -0,0 +1,102 @@
+#ifndef SLIDING_STATS_H
+#define SLIDING_STATS_H
+
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include "stats_partial.h"
+
+// Estadísticas sobre una ventana deslizante de las últimas capacity muestras.
+// Cada push/pop actualiza en O(1) los mismos acumuladores que StatsTask
+// (suma de logaritmos, suma y número de elementos) y un contador de ceros en
+// lugar del has_zero pegajoso, así que un cero deja de anular el producto
+// cuando sale de la ventana. La moda usa los índices dentro de la ventana,
+// igual que recalcular computeMetrics sobre su contenido.
+//
+// Las bajas restan de los acumuladores: con PlainAccumulator el redondeo se
+// acumula con el tiempo, con KahanAccumulator mucho menos; resync() recalcula
+// desde el anillo en O(capacity).
+template <typename T, typename Acc>
+class SlidingStats {
+    std::unique_ptr<T[]> ring;
+    std::size_t cap;
+    std::size_t head = 0; // posición de la muestra más antigua
+    std::size_t count = 0;
+    Acc log_sum;
+    Acc sum;
+    long long zeros = 0;
+    long long negatives = 0;
+
+    void addSample(double val, double sign) {
+        if (val == 0) {
+            zeros += static_cast<long long>(sign);
+        } else {
+            log_sum.add(sign * std::log(std::abs(val)));
+        }
+        if (val < 0) {
+            negatives += static_cast<long long>(sign);
+        }
+        sum.add(sign * val);
+    }
+
+public:
+    explicit SlidingStats(std::size_t capacity)
+        : ring(new T[capacity > 0 ? capacity : 1]), cap(capacity > 0 ? capacity : 1) {}
+
+    std::size_t size() const { return count; }
+    std::size_t capacity() const { return cap; }
+    bool empty() const { return count == 0; }
+    bool full() const { return count == cap; }
+
+    // Añade una muestra; con la ventana llena sale antes la más antigua
+    void push(T value) {
+        if (full()) {
+            pop();
+        }
+        std::size_t tail = head + count;
+        ring[tail < cap ? tail : tail - cap] = value;
+        ++count;
+        addSample(static_cast<double>(value), 1.0);
+    }
+
+    // Quita la muestra más antigua
+    void pop() {
+        if (empty()) {
+            return;
+        }
+        addSample(static_cast<double>(ring[head]), -1.0);
+        head = (head + 1 == cap) ? 0 : head + 1;
+        --count;
+    }
+
+    // Recalcula los acumuladores desde el contenido del anillo
+    void resync() {
+        log_sum = Acc();
+        sum = Acc();
+        zeros = 0;
+        negatives = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            std::size_t pos = head + i;
+            addSample(static_cast<double>(ring[pos < cap ? pos : pos - cap]), 1.0);
+        }
+    }
+
+    // Parcial equivalente al de un StatsTask sobre la ventana
+    StatsPartial<Acc> partial() const {
+        StatsPartial<Acc> p;
+        p.log_sum = log_sum;
+        p.sum = sum;
+        p.diff_sum = sum;
+        p.diff_sum.add(-(static_cast<double>(count) * (static_cast<double>(count) - 1) / 2)); // sum(i)
+        p.count = static_cast<long long>(count);
+        p.has_zero = zeros > 0;
+        p.negative = negatives % 2 != 0;
+        return p;
+    }
+
+    void stats(double& mode, double& stddev, ProductValue& sum_out) const {
+        finalizeStats(partial(), mode, stddev, sum_out);
+    }
+};
+
+#endif // SLIDING_STATS_H
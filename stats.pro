@@ -0,0 +1,22 @@
+# DivideConquer y el resto de estrategias sobre WorkerPool
+include(common.pri)
+SOURCES += main.cc
+TARGET = stats
+
+# qmake CONFIG+=cuda: estrategia --gpu (gpu_stats.cu) compilada con nvcc
+cuda {
+    DEFINES += STATS_WITH_CUDA
+    CUDA_SOURCES += $$PWD/gpu_stats.cu
+    isEmpty(NVCC) {
+        NVCC = nvcc
+    }
+    !system($$NVCC --version > /dev/null 2>&1) {
+        error("CONFIG+=cuda necesita nvcc (o NVCC=ruta/a/nvcc)")
+    }
+    cuda_compiler.input = CUDA_SOURCES
+    cuda_compiler.output = ${QMAKE_FILE_BASE}_cuda.o
+    cuda_compiler.commands = $$NVCC -O3 -std=c++17 -DSTATS_WITH_CUDA -c ${QMAKE_FILE_NAME} -o ${QMAKE_FILE_OUT}
+    cuda_compiler.variable_out = OBJECTS
+    QMAKE_EXTRA_COMPILERS += cuda_compiler
+    LIBS += -lcudart
+}
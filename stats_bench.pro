@@ -0,0 +1,5 @@
+# Microbenchmarks de núcleos, reparto y reducción con Google Benchmark
+include(common.pri)
+SOURCES += microbench.cc
+TARGET = stats_bench
+LIBS += -lbenchmark
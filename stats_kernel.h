@@ -0,0 +1,426 @@
+#ifndef STATS_KERNEL_H
+#define STATS_KERNEL_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include "metrics.h"
+#include "stats_partial.h"
+
+// Núcleos de cálculo de un trozo [start, end): suma, suma de logaritmos,
+// suma de diferencias (data[i] - i) y detección de ceros. base es el índice
+// global de data[0], para datos que llegan por partes. Son plantillas sobre
+// el tipo de elemento T (double, float, int32, int64) y la política de
+// acumulación Acc. Hay una versión escalar y versiones vectoriales que se
+// eligen en tiempo de ejecución.
+
+enum StatsIsa { ISA_SCALAR, ISA_AVX2, ISA_AVX512, ISA_NEON };
+
+struct StatsKernel {
+    const char* name;
+    StatsIsa isa;
+};
+
+template <typename T, typename Acc>
+void statsKernelScalar(const T* data, std::size_t start, std::size_t end, long long base, StatsPartial<Acc>& out) {
+    StatsPartial<Acc> local;
+
+    for (std::size_t i = start; i < end; ++i) {
+        double val = static_cast<double>(data[i]);
+        if (val == 0) {
+            local.has_zero = true;
+        } else {
+            local.log_sum.add(std::log(std::abs(val)));
+        }
+        local.negative = local.negative != (val < 0);
+        local.sum.add(val);
+        local.diff_sum.add(val - (base + static_cast<long long>(i))); // Moda: data[i] - i
+        local.count++;
+    }
+
+    out = local;
+}
+
+// Tipos vectoriales de W lanes de double (extensiones vectoriales de GCC),
+// más los de 2W floats y los de W elementos de 32 bits para las cargas
+template <int W> struct SimdLanes;
+template <> struct SimdLanes<2> {
+    typedef double vd __attribute__((vector_size(16)));
+    typedef long long vi __attribute__((vector_size(16)));
+    typedef float vf __attribute__((vector_size(16)));
+    typedef int vfi __attribute__((vector_size(16)));
+    typedef float vhf __attribute__((vector_size(8)));
+    typedef int vhi __attribute__((vector_size(8)));
+};
+template <> struct SimdLanes<4> {
+    typedef double vd __attribute__((vector_size(32)));
+    typedef long long vi __attribute__((vector_size(32)));
+    typedef float vf __attribute__((vector_size(32)));
+    typedef int vfi __attribute__((vector_size(32)));
+    typedef float vhf __attribute__((vector_size(16)));
+    typedef int vhi __attribute__((vector_size(16)));
+};
+template <> struct SimdLanes<8> {
+    typedef double vd __attribute__((vector_size(64)));
+    typedef long long vi __attribute__((vector_size(64)));
+    typedef float vf __attribute__((vector_size(64)));
+    typedef int vfi __attribute__((vector_size(64)));
+    typedef float vhf __attribute__((vector_size(32)));
+    typedef int vhi __attribute__((vector_size(32)));
+};
+
+// Carga W elementos consecutivos convertidos a double. Los vectores se pasan
+// por referencia: estas funciones sólo existen inlineadas en los núcleos con
+// target, y así no cambian la ABI fuera de ellos.
+template <int W>
+__attribute__((always_inline)) inline void loadLanes(const double* p, typename SimdLanes<W>::vd& out) {
+    std::memcpy(&out, p, sizeof(out));
+}
+
+template <int W>
+__attribute__((always_inline)) inline void loadLanes(const float* p, typename SimdLanes<W>::vd& out) {
+    typename SimdLanes<W>::vhf v;
+    std::memcpy(&v, p, sizeof(v));
+    out = __builtin_convertvector(v, typename SimdLanes<W>::vd);
+}
+
+template <int W>
+__attribute__((always_inline)) inline void loadLanes(const std::int32_t* p, typename SimdLanes<W>::vd& out) {
+    typename SimdLanes<W>::vhi v;
+    std::memcpy(&v, p, sizeof(v));
+    out = __builtin_convertvector(v, typename SimdLanes<W>::vd);
+}
+
+template <int W>
+__attribute__((always_inline)) inline void loadLanes(const std::int64_t* p, typename SimdLanes<W>::vd& out) {
+    typename SimdLanes<W>::vi v;
+    std::memcpy(&v, p, sizeof(v));
+    out = __builtin_convertvector(v, typename SimdLanes<W>::vd);
+}
+
+// Logaritmo de W doubles finitos positivos: aproximación racional de Cephes
+template <int W>
+__attribute__((always_inline)) inline void logLanes(const typename SimdLanes<W>::vd& x,
+                                                    typename SimdLanes<W>::vd& out) {
+    typedef typename SimdLanes<W>::vd vd;
+    typedef typename SimdLanes<W>::vi vi;
+
+    const vd sqrth = vd{} + 0.70710678118654752440;
+    const vi exp_mask = vi{} + 0x7ffLL;
+    const vi mant_mask = vi{} + 0x000fffffffffffffLL;
+    const vi half_bits = vi{} + 0x3fe0000000000000LL; // 0.5
+    const vi magic_bits = vi{} + 0x4330000000000000LL; // 2^52
+    const vd magic = vd{} + 4503599627370496.0;
+
+    // frexp: x = m * 2^e con m en [0.5, 1)
+    vi bits = (vi)x;
+    vi biased = (bits >> 52) & exp_mask;
+    vd m = (vd)((bits & mant_mask) | half_bits);
+    vd e = ((vd)(biased | magic_bits) - magic) - 1022.0;
+
+    vi small = (m < sqrth);
+    e = small ? e - 1.0 : e;
+    vd f = small ? (m + m) - 1.0 : m - 1.0;
+
+    vd z = f * f;
+    vd p = ((((1.01875663804580931796E-4 * f + 4.97494994976747001425E-1) * f
+              + 4.70579119878881725854E0) * f + 1.44989225341610930846E1) * f
+              + 1.79368678507819816313E1) * f + 7.70838733755885391666E0;
+    vd q = ((((f + 1.12873587189167450590E1) * f + 4.52279145837532221105E1) * f
+              + 8.29875266912776603211E1) * f + 7.11544750618563894466E1) * f
+              + 2.31251620126765340583E1;
+    vd y = f * (z * p / q);
+    y = y - e * 2.121944400546905827679e-4;
+    y = y - 0.5 * z;
+    out = (f + y) + e * 0.693359375;
+}
+
+// Logaritmo de 2W floats finitos positivos (logf de Cephes): el doble de
+// carriles que la versión double, con precisión de float
+template <int W>
+__attribute__((always_inline)) inline void logLanesFloat(const typename SimdLanes<W>::vf& x,
+                                                         typename SimdLanes<W>::vf& out) {
+    typedef typename SimdLanes<W>::vf vf;
+    typedef typename SimdLanes<W>::vfi vfi;
+
+    vfi bits = (vfi)x;
+    vfi biased = (bits >> 23) & 0xff;
+    vf m = (vf)((bits & 0x007fffff) | 0x3f000000); // mantisa en [0.5, 1)
+    vf e = __builtin_convertvector(biased - 126, vf);
+
+    vfi small = (m < 0.707106781186547524f);
+    e = small ? e - 1.0f : e;
+    vf f = small ? (m + m) - 1.0f : m - 1.0f;
+
+    vf z = f * f;
+    vf y = ((((((((7.0376836292E-2f * f - 1.1514610310E-1f) * f + 1.1676998740E-1f) * f
+               - 1.2420140846E-1f) * f + 1.4249322787E-1f) * f - 1.6668057665E-1f) * f
+               + 2.0000714765E-1f) * f - 2.4999993993E-1f) * f + 3.3333331174E-1f) * f * z;
+    y = y - e * 2.12194440e-4f;
+    y = y - 0.5f * z;
+    out = (f + y) + e * 0.693359375f;
+}
+
+// Suma por carriles; con una política compensada cada carril lleva su
+// término de corrección de Neumaier
+template <typename V, bool Compensated>
+struct LaneSum {
+    V total = V{};
+
+    __attribute__((always_inline)) void add(const V& x) { total += x; }
+
+    template <typename Acc>
+    __attribute__((always_inline)) void reduce(Acc& acc, int lanes) const {
+        for (int l = 0; l < lanes; ++l) {
+            acc.add(total[l]);
+        }
+    }
+};
+
+template <typename V>
+struct LaneSum<V, true> {
+    V total = V{};
+    V comp = V{};
+
+    __attribute__((always_inline)) void add(const V& x) {
+        V t = total + x;
+        V abs_total = total < 0 ? -total : total;
+        V abs_x = x < 0 ? -x : x;
+        comp += (abs_total >= abs_x) ? (total - t) + x : (x - t) + total;
+        total = t;
+    }
+
+    template <typename Acc>
+    __attribute__((always_inline)) void reduce(Acc& acc, int lanes) const {
+        for (int l = 0; l < lanes; ++l) {
+            acc.add(total[l]);
+            acc.add(comp[l]);
+        }
+    }
+};
+
+// Acumuladores por carril de un núcleo de W lanes
+template <int W, typename Acc>
+struct LaneStats {
+    typedef typename SimdLanes<W>::vd vd;
+    typedef typename SimdLanes<W>::vi vi;
+
+    LaneSum<vd, Acc::compensated> log_sum, sum, diff_sum;
+    vd idx;
+
+    // val son W datos ya convertidos a double y log_val sus logaritmos (0 en
+    // los ceros); los ceros los detecta el núcleo en el tipo de origen
+    __attribute__((always_inline)) void add(const vd& val, const vd& log_val) {
+        sum.add(val);
+        diff_sum.add(val - idx); // Moda: data[i] - i
+        idx += W;
+        log_sum.add(log_val);
+    }
+
+    __attribute__((always_inline)) void reduce(StatsPartial<Acc>& out) const {
+        log_sum.reduce(out.log_sum, W);
+        sum.reduce(out.sum, W);
+        diff_sum.reduce(out.diff_sum, W);
+    }
+};
+
+// Distancia de prefetch software en bytes (0 = sin prefetch, sólo el de
+// hardware); se fija al arrancar con --prefetch
+inline std::size_t stats_prefetch_bytes = 0;
+
+// Pide a la caché el dato que está ahead elementos por delante de i, sin
+// salirse de [i, end); nivel de localidad 0 porque cada dato se lee una vez
+template <typename T>
+__attribute__((always_inline)) inline void prefetchAhead(const T* data, std::size_t i, std::size_t end,
+                                                         std::size_t ahead) {
+    if (ahead != 0 && ahead < end - i) {
+        __builtin_prefetch(data + i + ahead, 0, 0);
+    }
+}
+
+// Cuerpo vectorial genérico de W lanes con las extensiones vectoriales de GCC.
+// Se instancia dentro de funciones con target("avx2"), target("avx512f") o en
+// NEON, de modo que el compilador lo traduce a las instrucciones de cada ISA.
+// El logaritmo es válido para valores finitos normales; los ceros se
+// sustituyen por 1 con la máscara de comparación para que aporten log = 0.
+// La paridad de negativos se lleva por lane con un XOR de las máscaras.
+// Con float el logaritmo se calcula sobre 2W floats por iteración. Con
+// stats_prefetch_bytes se adelanta la lectura de cada iteración.
+template <int W, typename T, typename Acc>
+__attribute__((always_inline)) inline void statsKernelBody(const T* data, std::size_t start, std::size_t end,
+                                                           long long base, StatsPartial<Acc>& out) {
+    typedef typename SimdLanes<W>::vd vd;
+    typedef typename SimdLanes<W>::vi vi;
+
+    LaneStats<W, Acc> lanes;
+    for (int l = 0; l < W; ++l) {
+        lanes.idx[l] = base + static_cast<long long>(start) + l;
+    }
+
+    bool has_zero = false;
+    bool negative = false;
+    std::size_t i = start;
+    const std::size_t ahead = stats_prefetch_bytes / sizeof(T);
+    if constexpr (std::is_same<T, float>::value) {
+        typedef typename SimdLanes<W>::vf vf;
+        typedef typename SimdLanes<W>::vfi vfi;
+        typedef typename SimdLanes<W>::vhf vhf;
+        vfi zero = vfi{};
+        vfi neg = vfi{};
+        for (; i + 2 * W <= end; i += 2 * W) {
+            prefetchAhead(data, i, end, ahead);
+            vf raw;
+            std::memcpy(&raw, data + i, sizeof(raw));
+            vfi is_zero = (raw == 0.0f);
+            zero |= is_zero;
+            neg ^= (raw < 0.0f);
+            vf x = (vf)((vfi)raw & 0x7fffffff);
+            x = is_zero ? vf{} + 1.0f : x;
+            vf logs;
+            logLanesFloat<W>(x, logs);
+
+            vhf lo, hi;
+            std::memcpy(&lo, &logs, sizeof(lo));
+            std::memcpy(&hi, reinterpret_cast<const char*>(&logs) + sizeof(lo), sizeof(hi));
+            vd val, log_val;
+            loadLanes<W>(data + i, val);
+            log_val = __builtin_convertvector(lo, vd);
+            lanes.add(val, log_val);
+            loadLanes<W>(data + i + W, val);
+            log_val = __builtin_convertvector(hi, vd);
+            lanes.add(val, log_val);
+        }
+        for (int l = 0; l < 2 * W; ++l) {
+            has_zero = has_zero || zero[l] != 0;
+            negative = negative != (neg[l] != 0);
+        }
+    } else {
+        const vd one = vd{} + 1.0;
+        const vi abs_mask = vi{} + 0x7fffffffffffffffLL;
+        vi zero = vi{};
+        vi neg = vi{};
+        for (; i + W <= end; i += W) {
+            prefetchAhead(data, i, end, ahead);
+            vd val, log_val;
+            loadLanes<W>(data + i, val);
+            vi is_zero = (val == 0.0);
+            zero |= is_zero;
+            neg ^= (val < 0.0);
+            vd x = (vd)((vi)val & abs_mask);
+            x = is_zero ? one : x;
+            logLanes<W>(x, log_val);
+            lanes.add(val, log_val);
+        }
+        for (int l = 0; l < W; ++l) {
+            has_zero = has_zero || zero[l] != 0;
+            negative = negative != (neg[l] != 0);
+        }
+    }
+
+    StatsPartial<Acc> local;
+    lanes.reduce(local);
+    local.has_zero = has_zero;
+    local.negative = negative;
+    local.count = i - start;
+
+    if (i < end) {
+        StatsPartial<Acc> tail;
+        statsKernelScalar(data, i, end, base, tail);
+        local.merge(tail);
+    }
+    out = local;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+template <typename T, typename Acc>
+__attribute__((target("avx2,fma"))) void statsKernelAvx2(const T* data, std::size_t start, std::size_t end,
+                                                          long long base, StatsPartial<Acc>& out) {
+    statsKernelBody<4>(data, start, end, base, out);
+}
+
+template <typename T, typename Acc>
+__attribute__((target("avx512f"))) void statsKernelAvx512(const T* data, std::size_t start, std::size_t end,
+                                                           long long base, StatsPartial<Acc>& out) {
+    statsKernelBody<8>(data, start, end, base, out);
+}
+#endif
+
+#if defined(__aarch64__)
+template <typename T, typename Acc>
+void statsKernelNeon(const T* data, std::size_t start, std::size_t end, long long base, StatsPartial<Acc>& out) {
+    statsKernelBody<2>(data, start, end, base, out);
+}
+#endif
+
+// Núcleo activo; se fija al arrancar con selectStatsKernel()
+inline StatsKernel active_stats_kernel = {"scalar", ISA_SCALAR};
+
+// Ejecuta el núcleo activo; las políticas no vectorizables siempre usan el escalar
+template <typename T, typename Acc>
+void dispatchStatsKernel(const T* data, std::size_t start, std::size_t end, long long base, StatsPartial<Acc>& out) {
+    if constexpr (Acc::vectorizable) {
+        switch (active_stats_kernel.isa) {
+#if defined(__x86_64__) || defined(__i386__)
+        case ISA_AVX2:
+            statsKernelAvx2(data, start, end, base, out);
+            return;
+        case ISA_AVX512:
+            statsKernelAvx512(data, start, end, base, out);
+            return;
+#endif
+#if defined(__aarch64__)
+        case ISA_NEON:
+            statsKernelNeon(data, start, end, base, out);
+            return;
+#endif
+        default:
+            break;
+        }
+    }
+    statsKernelScalar(data, start, end, base, out);
+}
+
+// Un trozo con el núcleo activo, contado en las métricas (ver metrics.h)
+template <typename T, typename Acc>
+void runStatsKernel(const T* data, std::size_t start, std::size_t end, long long base, StatsPartial<Acc>& out) {
+    long long begin = metricsNow();
+    dispatchStatsKernel(data, start, end, base, out);
+    metricsKernel(begin, end - start);
+}
+
+// Elige el núcleo por nombre ("auto", "scalar", "avx2", "avx512", "neon").
+// Devuelve false si no existe, la CPU no lo soporta o la política de
+// acumulación no admite núcleos vectoriales (vector_ok).
+inline bool selectStatsKernel(const std::string& name, bool vector_ok = true) {
+    StatsKernel chosen = {"scalar", ISA_SCALAR};
+    bool found = (name == "scalar");
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    bool has_avx512 = vector_ok && __builtin_cpu_supports("avx512f");
+    bool has_avx2 = vector_ok && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    if ((name == "avx512" || name == "auto") && has_avx512) {
+        chosen = {"avx512", ISA_AVX512};
+        found = true;
+    } else if ((name == "avx2" || name == "auto") && has_avx2) {
+        chosen = {"avx2", ISA_AVX2};
+        found = true;
+    }
+#elif defined(__aarch64__)
+    if ((name == "neon" || name == "auto") && vector_ok) {
+        chosen = {"neon", ISA_NEON};
+        found = true;
+    }
+#endif
+    if (name == "auto") {
+        found = true;
+    }
+    if (found) {
+        active_stats_kernel = chosen;
+    }
+    return found;
+}
+
+#endif // STATS_KERNEL_H
@@ -0,0 +1,104 @@
+#ifndef STATS_PARTIAL_H
+#define STATS_PARTIAL_H
+
+#include <cmath>
+#include <cstddef>
+#include <ostream>
+#include <vector>
+#include "accumulator.h"
+
+// Resultado parcial de un trozo. Cada tarea escribe en su propia ranura,
+// alineada a línea de caché para que dos trozos nunca compartan línea. Acc
+// es la política de acumulación de las sumas (ver accumulator.h).
+template <typename Acc>
+struct alignas(64) StatsPartial {
+    Acc log_sum;
+    Acc sum;
+    Acc diff_sum;
+    long long count = 0;
+    bool has_zero = false;
+    bool negative = false; // número impar de valores negativos: signo del producto
+
+    void merge(const StatsPartial& other) {
+        log_sum.merge(other.log_sum);
+        sum.merge(other.sum);
+        diff_sum.merge(other.diff_sum);
+        count += other.count;
+        has_zero = has_zero || other.has_zero;
+        negative = negative != other.negative;
+    }
+};
+
+// Reducción en árbol por pares: el orden de las sumas depende sólo del número
+// de trozos, no del orden en que terminen los hilos, así que es reproducible.
+template <typename Acc>
+StatsPartial<Acc> reducePartials(StatsPartial<Acc>* partials, std::size_t n) {
+    if (n == 0) {
+        return StatsPartial<Acc>();
+    }
+    for (std::size_t step = 1; step < n; step *= 2) {
+        for (std::size_t i = 0; i + step < n; i += 2 * step) {
+            partials[i].merge(partials[i + step]);
+        }
+    }
+    return partials[0];
+}
+
+template <typename Acc>
+StatsPartial<Acc> reducePartials(std::vector<StatsPartial<Acc>>& partials) {
+    return reducePartials(partials.data(), partials.size());
+}
+
+// Producto de los datos como signo y log10 de su valor absoluto: se obtiene
+// de log_sum sin calcular nunca la exponencial, así que no se desborda con
+// entradas grandes. Se imprime como un double mientras quepa en uno y si no
+// como mantisa y exponente decimal.
+struct ProductValue {
+    bool zero = true;
+    bool negative = false;
+    double log10_abs = 0;
+
+    // Como double: ±inf o 0 si no cabe
+    double value() const {
+        if (zero) {
+            return 0;
+        }
+        double v = std::pow(10.0, log10_abs);
+        return negative ? -v : v;
+    }
+};
+
+inline std::ostream& operator<<(std::ostream& out, const ProductValue& p) {
+    if (p.zero || std::abs(p.log10_abs) < 300 || !std::isfinite(p.log10_abs)) {
+        return out << p.value();
+    }
+    // Mantisa redondeada a la precisión del flujo, como haría con un double
+    double exponent = std::floor(p.log10_abs);
+    double scale = std::pow(10.0, std::max<std::streamsize>(out.precision(), 1) - 1);
+    double mantissa = std::round(std::pow(10.0, p.log10_abs - exponent) * scale) / scale;
+    if (mantissa >= 10) {
+        mantissa /= 10;
+        exponent += 1;
+    }
+    return out << (p.negative ? -mantissa : mantissa) << "e" << (exponent < 0 ? "-" : "+")
+               << static_cast<long long>(std::abs(exponent));
+}
+
+// Resultado final de un cálculo: moda, desviación estándar y suma
+struct StatsResult {
+    double mode = 0;
+    double stddev = 0;
+    ProductValue sum;
+};
+
+template <typename Acc>
+void finalizeStats(const StatsPartial<Acc>& total, double& mode, double& stddev, ProductValue& sum) {
+    mode = total.count > 0 ? total.diff_sum.value() / total.count : 0.0; // Moda: promedio de diferencias
+    stddev = total.sum.value() / 2.0; // Desviación estándar: suma total / 2
+    // Sumatoria: producto, con el signo de la paridad de negativos
+    sum.zero = total.has_zero;
+    sum.negative = total.negative;
+    sum.log10_abs = total.log_sum.value() / std::log(10.0);
+}
+
+#endif // STATS_PARTIAL_H
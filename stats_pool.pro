@@ -0,0 +1,4 @@
+# ThreadPool (QThreadPool), WorkStealing y Adaptive
+include(common.pri)
+SOURCES += maincontodo.cc
+TARGET = stats_pool
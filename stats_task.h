@@ -0,0 +1,56 @@
+#ifndef STATS_TASK_H
+#define STATS_TASK_H
+
+#include <cstddef>
+#include "dataset.h"
+#include "exact_partial.h"
+#include "stats_kernel.h"
+#include "stats_partial.h"
+#include "trace.h"
+
+// Clase para manejar las tareas estadísticas, sobre datos de tipo T y con
+// la política de acumulación Acc. Con collectExact() la misma pasada
+// acumula también las estadísticas exactas (ver exact_partial.h).
+template <typename T, typename Acc>
+class StatsTask {
+    const DataSpan<T> data;
+    std::size_t start, end;
+    StatsPartial<Acc>& result;
+    long long base; // índice global de data[0]
+    ExactPartial<T>* exact = nullptr;
+#ifdef STATS_TRACE
+    long long trace_id = 0;
+#endif
+
+public:
+    StatsTask(DataSpan<T> d, std::size_t s, std::size_t e, StatsPartial<Acc>& r, long long b = 0)
+        : data(d), start(s), end(e), result(r), base(b) {}
+
+    void collectExact(ExactPartial<T>& e) { exact = &e; }
+
+    // Registra el encolado de la tarea (sólo con STATS_TRACE)
+    void markEnqueued() {
+#ifdef STATS_TRACE
+        trace_id = traceNextId();
+        traceEnqueue(trace_id);
+#endif
+    }
+
+    void computeMetrics() {
+#ifdef STATS_TRACE
+        if (trace_id != 0) {
+            traceDequeue(trace_id);
+        }
+#endif
+        long long begin = traceNow();
+        if (exact) {
+            runExactKernel(data.ptr, start, end, base, result, *exact);
+        } else {
+            runStatsKernel(data.ptr, start, end, base, result); // una única escritura, sin mutex
+        }
+        traceSpan("computeMetrics", begin, base + static_cast<long long>(start),
+                  base + static_cast<long long>(end));
+    }
+};
+
+#endif // STATS_TASK_H
@@ -0,0 +1,27 @@
+#ifndef STATS_TYPES_H
+#define STATS_TYPES_H
+
+#include <cstdint>
+#include "accumulator.h"
+
+// Tipo de los datos de entrada y política de acumulación del programa, fijados
+// al compilar: qmake "DEFINES+=STATS_ELEMENT=float STATS_ACCUMULATOR=KahanAccumulator".
+// Los ficheros (-f y -S) contienen valores binarios de este tipo.
+#ifndef STATS_ELEMENT
+#define STATS_ELEMENT double
+#endif
+#ifndef STATS_ACCUMULATOR
+#define STATS_ACCUMULATOR PlainAccumulator
+#endif
+
+typedef STATS_ELEMENT Element;
+typedef STATS_ACCUMULATOR Accumulator;
+
+// Nombre del tipo de elemento para los informes
+template <typename T> inline const char* elementName();
+template <> inline const char* elementName<double>() { return "double"; }
+template <> inline const char* elementName<float>() { return "float"; }
+template <> inline const char* elementName<std::int32_t>() { return "int32"; }
+template <> inline const char* elementName<std::int64_t>() { return "int64"; }
+
+#endif // STATS_TYPES_H
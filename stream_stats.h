@@ -0,0 +1,199 @@
+#ifndef STREAM_STATS_H
+#define STREAM_STATS_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include "chunking.h"
+#include "dataset.h"
+#include "stats_partial.h"
+#include "stats_task.h"
+#include "trace.h"
+#include "worker_pool.h"
+
+// Elementos por buffer y número de buffers en circulación: la memoria queda
+// acotada a STREAM_BUFFERS * buffer_elems elementos sea cual sea la entrada.
+const std::size_t DEFAULT_STREAM_BUFFER = 1 << 20;
+const int STREAM_BUFFERS = 3;
+
+template <typename T>
+struct StreamBuffer {
+    std::unique_ptr<T[]> values;
+    std::size_t count = 0;
+    bool last = false; // fin de la entrada (o error de lectura)
+};
+
+// Cola bloqueante de buffers entre el lector y el consumidor
+template <typename T>
+class BufferQueue {
+    std::deque<StreamBuffer<T>*> items;
+    std::mutex mutex;
+    std::condition_variable ready;
+
+public:
+    void push(StreamBuffer<T>* b) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            items.push_back(b);
+        }
+        ready.notify_one();
+    }
+
+    StreamBuffer<T>* pop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        ready.wait(lock, [this] { return !items.empty(); });
+        StreamBuffer<T>* b = items.front();
+        items.pop_front();
+        return b;
+    }
+};
+
+// Abre la entrada del flujo: el fichero indicado o stdin si es "" o "-"
+inline int openStreamInput(const std::string& file) {
+    if (file.empty() || file == "-") {
+        return STDIN_FILENO;
+    }
+    int fd = ::open(file.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Error: no se pudo abrir " << file << "\n";
+    }
+    return fd;
+}
+
+// Lee hasta llenar el buffer o llegar al fin de la entrada. Los bytes de un
+// valor incompleto se conservan en carry para el siguiente buffer.
+template <typename T>
+bool fillBuffer(int fd, StreamBuffer<T>& b, std::size_t capacity,
+                std::vector<char>& carry, bool& failed) {
+    char* out = reinterpret_cast<char*>(b.values.get());
+    std::size_t bytes = carry.size();
+    std::memcpy(out, carry.data(), bytes);
+    carry.clear();
+
+    std::size_t want = capacity * sizeof(T);
+    bool eof = false;
+    while (bytes < want) {
+        ssize_t r = ::read(fd, out + bytes, want - bytes);
+        if (r < 0) {
+            failed = true;
+            eof = true;
+            break;
+        }
+        if (r == 0) {
+            eof = true;
+            break;
+        }
+        bytes += r;
+    }
+
+    b.count = bytes / sizeof(T);
+    carry.assign(out + b.count * sizeof(T), out + bytes);
+    b.last = eof;
+    return !eof;
+}
+
+// Recorre el flujo: un hilo lector rellena buffers de tamaño fijo desde fd
+// mientras se procesa el anterior con reduce(span, offset, total), donde
+// offset es el índice global de span[0] y total acumula en orden los
+// parciales de todos los buffers. T es el tipo de los valores del flujo.
+template <typename T, typename Acc, typename Reduce>
+bool streamBuffers(int fd, std::size_t buffer_elems, StatsPartial<Acc>& total, Reduce reduce) {
+    buffer_elems = std::max<std::size_t>(buffer_elems, 1);
+    StreamBuffer<T> buffers[STREAM_BUFFERS];
+    BufferQueue<T> free_buffers, full_buffers;
+    for (auto& b : buffers) {
+        b.values.reset(new T[buffer_elems]);
+        free_buffers.push(&b);
+    }
+
+    bool failed = false;
+    std::thread reader([&] {
+        std::vector<char> carry;
+        bool more = true;
+        while (more) {
+            StreamBuffer<T>* b = free_buffers.pop();
+            long long begin = traceNow();
+            more = fillBuffer(fd, *b, buffer_elems, carry, failed);
+            traceSpan("read", begin);
+            full_buffers.push(b);
+        }
+        if (!carry.empty()) {
+            failed = true; // el flujo no contiene un número entero de valores
+        }
+    });
+
+    long long offset = 0;
+    total = StatsPartial<Acc>();
+    bool reduced = true;
+
+    bool done = false;
+    while (!done) {
+        StreamBuffer<T>* b = full_buffers.pop();
+        done = b->last;
+
+        DataSpan<T> span;
+        span.ptr = b->values.get();
+        span.count = b->count;
+        // Tras un fallo se siguen vaciando los buffers para que el lector termine
+        if (reduced && !span.empty()) {
+            reduced = reduce(span, offset, total);
+        }
+        offset += static_cast<long long>(span.size());
+
+        if (!done) {
+            free_buffers.push(b);
+        }
+    }
+    reader.join();
+
+    if (failed) {
+        std::cerr << "Error: lectura incompleta del flujo de entrada\n";
+        return false;
+    }
+    return reduced;
+}
+
+// Estadísticas en flujo sobre el pool: cada buffer se trocea en tareas
+// StatsTask con su índice global de inicio, así que el resultado no depende
+// del tamaño de buffer más allá del redondeo
+template <typename T, typename Acc>
+bool streamStats(WorkerPool& pool, int fd, std::size_t buffer_elems, StatsPartial<Acc>& total) {
+    int parts = pool.size() + 1; // el hilo consumidor también calcula
+    return streamBuffers<T>(fd, buffer_elems, total, [&pool, parts](DataSpan<T> span, long long offset,
+                                                                     StatsPartial<Acc>& acc) {
+        std::size_t size = span.size();
+        std::size_t chunks = chunkCount(size, parts);
+
+        pool.arena().reset();
+        StatsPartial<Acc>* partials = pool.arena().allocate<StatsPartial<Acc>>(chunks);
+        StatsTask<T, Acc>* tasks = pool.arena().allocate<StatsTask<T, Acc>>(chunks);
+        for (std::size_t i = 0; i < chunks; ++i) {
+            std::size_t start = chunkBoundary(span.ptr, size, chunks, i);
+            std::size_t end = chunkBoundary(span.ptr, size, chunks, i + 1);
+            new (&partials[i]) StatsPartial<Acc>();
+            new (&tasks[i]) StatsTask<T, Acc>(span, start, end, partials[i], offset);
+        }
+        for (std::size_t i = 1; i < chunks; ++i) {
+            StatsTask<T, Acc>* task = &tasks[i];
+            task->markEnqueued();
+            pool.submit([task] { task->computeMetrics(); });
+        }
+        tasks[0].computeMetrics();
+        pool.wait();
+
+        acc.merge(reducePartials(partials, chunks));
+        return true;
+    });
+}
+
+#endif // STREAM_STATS_H
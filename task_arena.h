@@ -0,0 +1,146 @@
+#ifndef TASK_ARENA_H
+#define TASK_ARENA_H
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Memoria reutilizable para las tareas de una llamada: cada estrategia pide
+// sus StatsTask y StatsPartial al arena de su pool en lugar de crear vectores
+// nuevos. reset() al inicio de cada llamada recupera todo el bloque; si una
+// llamada no cupo, el bloque crece hasta el máximo visto, así que en régimen
+// estacionario no se reserva memoria. No es seguro entre hilos: lo usa sólo
+// el hilo que reparte el trabajo, y con una llamada a la vez por pool.
+class TaskArena {
+    static const std::size_t ALIGN = 64;
+
+    void* block = nullptr;
+    std::size_t capacity = 0;
+    std::size_t used = 0;
+    std::size_t high_water = 0;
+    std::vector<void*> overflow; // reservas que no cupieron en el bloque
+
+    static void* allocateBlock(std::size_t bytes) {
+        return ::operator new(bytes, std::align_val_t(ALIGN));
+    }
+
+    static void releaseBlock(void* p) {
+        ::operator delete(p, std::align_val_t(ALIGN));
+    }
+
+    void releaseOverflow() {
+        for (void* p : overflow) {
+            releaseBlock(p);
+        }
+        overflow.clear();
+    }
+
+public:
+    explicit TaskArena(std::size_t initial_bytes = 1 << 14) {
+        overflow.reserve(16);
+        if (initial_bytes > 0) {
+            block = allocateBlock(initial_bytes);
+            capacity = initial_bytes;
+        }
+    }
+
+    ~TaskArena() {
+        releaseOverflow();
+        if (block) {
+            releaseBlock(block);
+        }
+    }
+
+    TaskArena(const TaskArena&) = delete;
+    TaskArena& operator=(const TaskArena&) = delete;
+
+    // Libera de golpe todo lo pedido desde el último reset()
+    void reset() {
+        high_water = std::max(high_water, used);
+        if (!overflow.empty()) {
+            releaseOverflow();
+            if (block) {
+                releaseBlock(block);
+            }
+            capacity = high_water;
+            block = allocateBlock(capacity);
+        }
+        used = 0;
+    }
+
+    // Espacio sin inicializar para n objetos U, alineado a línea de caché.
+    // Los objetos nunca se destruyen, por eso U debe ser trivialmente destructible.
+    template <typename U>
+    U* allocate(std::size_t n) {
+        static_assert(std::is_trivially_destructible<U>::value,
+                      "TaskArena no llama a los destructores");
+        std::size_t bytes = (n * sizeof(U) + ALIGN - 1) / ALIGN * ALIGN;
+        if (bytes == 0) {
+            return nullptr;
+        }
+        used += bytes;
+        if (used <= capacity) {
+            return reinterpret_cast<U*>(static_cast<char*>(block) + used - bytes);
+        }
+        overflow.push_back(allocateBlock(bytes));
+        return static_cast<U*>(overflow.back());
+    }
+
+    std::size_t capacityBytes() const { return capacity; }
+};
+
+// Cola circular de capacidad potencia de dos: sustituye a std::deque en las
+// colas de los pools. Sólo reserva memoria al llenarse, nunca al vaciarse,
+// así que tras las primeras llamadas encolar y desencolar no reservan nada.
+template <typename T>
+class TaskRing {
+    std::vector<T> slots;
+    std::size_t mask = 0;
+    std::size_t head = 0; // primer elemento
+    std::size_t tail = 0; // una posición después del último
+
+    void grow() {
+        std::size_t capacity = std::max<std::size_t>(2 * (mask + 1), 16);
+        std::vector<T> bigger(capacity);
+        std::size_t count = size();
+        for (std::size_t i = 0; i < count; ++i) {
+            bigger[i] = std::move(slots[(head + i) & mask]);
+        }
+        slots = std::move(bigger);
+        mask = capacity - 1;
+        head = 0;
+        tail = count;
+    }
+
+public:
+    explicit TaskRing(std::size_t capacity = 64) {
+        std::size_t c = 16;
+        while (c < capacity) {
+            c *= 2;
+        }
+        slots.resize(c);
+        mask = c - 1;
+    }
+
+    bool empty() const { return head == tail; }
+    std::size_t size() const { return tail - head; }
+
+    void push_back(T value) {
+        if (size() == mask + 1) {
+            grow();
+        }
+        slots[tail++ & mask] = std::move(value);
+    }
+
+    T& front() { return slots[head & mask]; }
+    T& back() { return slots[(tail - 1) & mask]; }
+
+    // Los huecos libres se vacían para soltar lo que capturaba la tarea
+    void pop_front() { slots[head++ & mask] = T(); }
+    void pop_back() { slots[--tail & mask] = T(); }
+};
+
+#endif // TASK_ARENA_H
@@ -0,0 +1,148 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <string>
+
+// Instrumentación opcional del camino caliente. Con STATS_TRACE definido se
+// registran, por hilo y sin bloqueos, los instantes de encolado, inicio y fin
+// de cada StatsTask y las esperas por cerrojos, y traceDump() los vuelca en
+// formato Chrome trace (chrome://tracing o ui.perfetto.dev). Sin la macro
+// todas las funciones son vacías y el compilador las elimina.
+
+#ifdef STATS_TRACE
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+struct TraceEvent {
+    const char* name;
+    char phase;       // 'X' intervalo, 's'/'f' flecha encolado -> inicio, 'C' contador
+    long long ts_ns;  // desde el inicio del programa
+    long long dur_ns;
+    long long id;     // identificador de tarea para las flechas
+    long long arg0;   // rango [arg0, arg1) o espera en ns
+    long long arg1;
+};
+
+struct TraceBuffer {
+    int tid;
+    std::vector<TraceEvent> events;
+};
+
+class TraceRegistry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<TraceBuffer>> buffers;
+
+public:
+    const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    std::atomic<long long> next_id{1};
+
+    static TraceRegistry& instance() {
+        static TraceRegistry registry;
+        return registry;
+    }
+
+    // Buffer propio del hilo; el cerrojo sólo se toma la primera vez
+    TraceBuffer& local() {
+        thread_local TraceBuffer* buffer = nullptr;
+        if (!buffer) {
+            std::lock_guard<std::mutex> lock(mutex);
+            buffers.emplace_back(new TraceBuffer);
+            buffer = buffers.back().get();
+            buffer->tid = static_cast<int>(buffers.size());
+            buffer->events.reserve(1 << 12);
+        }
+        return *buffer;
+    }
+
+    // Sólo debe llamarse con los pools en reposo
+    bool dump(const std::string& path) {
+        std::ofstream out(path);
+        if (!out.is_open()) {
+            std::cerr << "Error: no se pudo abrir " << path << "\n";
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        out << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n";
+        bool first = true;
+        for (const auto& b : buffers) {
+            for (const TraceEvent& e : b->events) {
+                out << (first ? "" : ",\n") << "{\"name\": \"" << e.name << "\", \"ph\": \"" << e.phase
+                    << "\", \"pid\": 1, \"tid\": " << b->tid << ", \"ts\": " << e.ts_ns / 1000.0;
+                if (e.phase == 'X') {
+                    out << ", \"dur\": " << e.dur_ns / 1000.0 << ", \"args\": {\"start\": " << e.arg0
+                        << ", \"end\": " << e.arg1 << "}";
+                } else if (e.phase == 'C') {
+                    out << ", \"args\": {\"wait_ns\": " << e.arg0 << "}";
+                } else {
+                    out << ", \"cat\": \"queue\", \"id\": " << e.id;
+                    if (e.phase == 'f') {
+                        out << ", \"bp\": \"e\"";
+                    }
+                }
+                out << "}";
+                first = false;
+            }
+        }
+        out << "\n]}\n";
+        return true;
+    }
+};
+
+inline long long traceNow() {
+    auto d = std::chrono::steady_clock::now() - TraceRegistry::instance().epoch;
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+}
+
+inline long long traceNextId() {
+    return TraceRegistry::instance().next_id.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline void traceRecord(const char* name, char phase, long long ts, long long dur,
+                        long long id, long long arg0, long long arg1) {
+    TraceRegistry::instance().local().events.push_back({name, phase, ts, dur, id, arg0, arg1});
+}
+
+// La tarea id entra en una cola
+inline void traceEnqueue(long long id) {
+    traceRecord("enqueue", 's', traceNow(), 0, id, 0, 0);
+}
+
+// La tarea id sale de la cola y empieza a ejecutarse en este hilo
+inline void traceDequeue(long long id) {
+    traceRecord("enqueue", 'f', traceNow(), 0, id, 0, 0);
+}
+
+// Intervalo [begin, ahora) con el rango de datos que cubre
+inline void traceSpan(const char* name, long long begin, long long start = 0, long long end = 0) {
+    traceRecord(name, 'X', begin, traceNow() - begin, 0, start, end);
+}
+
+// Cerrojo obtenido tras esperar desde before
+inline void traceLockAcquired(const char* name, long long before) {
+    long long now = traceNow();
+    traceRecord(name, 'C', now, 0, 0, now - before, 0);
+}
+
+inline bool traceDump(const std::string& path) {
+    return TraceRegistry::instance().dump(path);
+}
+
+#else
+
+inline long long traceNow() { return 0; }
+inline long long traceNextId() { return 0; }
+inline void traceEnqueue(long long) {}
+inline void traceDequeue(long long) {}
+inline void traceSpan(const char*, long long, long long = 0, long long = 0) {}
+inline void traceLockAcquired(const char*, long long) {}
+inline bool traceDump(const std::string&) { return false; }
+
+#endif // STATS_TRACE
+
+#endif // TRACE_H
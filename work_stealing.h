@@ -0,0 +1,174 @@
+#ifndef WORK_STEALING_H
+#define WORK_STEALING_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+#include "metrics.h"
+#include "task_arena.h"
+#include "trace.h"
+
+// Pool con una cola por hilo y robo de tareas a una víctima aleatoria.
+// Cada hilo consume su cola por detrás y, cuando se queda sin trabajo,
+// roba por delante de la cola de otro hilo.
+class WorkStealingPool {
+    struct alignas(64) WorkerQueue {
+        std::mutex mutex;
+        TaskRing<int> tasks;
+    };
+
+    std::unique_ptr<WorkerQueue[]> queues;
+    std::vector<std::thread> workers;
+    std::function<void(int)> job; // tarea actual, recibe el índice del trozo
+    TaskArena task_arena;
+    std::atomic<int> remaining{0};
+    std::mutex mutex;
+    std::condition_variable work_available;
+    std::condition_variable work_done;
+    unsigned generation = 0;
+    int active = 0;
+    bool stopping = false;
+
+    bool popLocal(int id, int& task) {
+        WorkerQueue& q = queues[id];
+        long long before = traceNow(), waiting = metricsNow();
+        std::lock_guard<std::mutex> lock(q.mutex);
+        traceLockAcquired("deque lock", before);
+        metricsLockAcquired(waiting);
+        if (q.tasks.empty()) {
+            return false;
+        }
+        task = q.tasks.back();
+        q.tasks.pop_back();
+        metricsQueued(-1);
+        return true;
+    }
+
+    bool steal(int id, int& task, std::minstd_rand& rng) {
+        int n = size();
+        if (n < 2) {
+            return false;
+        }
+        // Víctima aleatoria; si está vacía se recorren las demás desde ahí
+        int first = std::uniform_int_distribution<int>(0, n - 1)(rng);
+        for (int k = 0; k < n; ++k) {
+            int victim = (first + k) % n;
+            if (victim == id) {
+                continue;
+            }
+            WorkerQueue& q = queues[victim];
+            long long before = traceNow(), waiting = metricsNow();
+            std::lock_guard<std::mutex> lock(q.mutex);
+            traceLockAcquired("deque lock", before);
+            metricsLockAcquired(waiting);
+            if (!q.tasks.empty()) {
+                task = q.tasks.front();
+                q.tasks.pop_front();
+                metricsQueued(-1);
+                metricsSteal();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void workerLoop(int id, std::function<void(int)> on_start) {
+        if (on_start) {
+            on_start(id);
+        }
+        std::minstd_rand rng(id + 1);
+        unsigned seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                work_available.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping) {
+                    return;
+                }
+                seen = generation;
+                ++active;
+            }
+
+            // Durante una ronda no se añaden tareas: si no queda nada en
+            // ninguna cola, este hilo ha terminado su parte.
+            int task;
+            while (popLocal(id, task) || steal(id, task, rng)) {
+                job(task);
+                if (remaining.fetch_sub(1) == 1) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    work_done.notify_all();
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--active == 0) {
+                work_done.notify_all();
+            }
+        }
+    }
+
+public:
+    static const int TASKS_PER_WORKER = 8;
+
+    // on_start(i) se ejecuta en el worker i antes de su primera ronda
+    explicit WorkStealingPool(int num_threads, std::function<void(int)> on_start = nullptr)
+        : queues(new WorkerQueue[num_threads > 0 ? num_threads : 1]) {
+        workers.reserve(num_threads);
+        for (int i = 0; i < num_threads; ++i) {
+            workers.emplace_back(&WorkStealingPool::workerLoop, this, i, on_start);
+        }
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        work_available.notify_all();
+        for (auto& t : workers) {
+            t.join();
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    int size() const { return static_cast<int>(workers.size()); }
+
+    // Memoria para las tareas de una llamada; sólo la usa el hilo que llama a run()
+    TaskArena& arena() { return task_arena; }
+
+    // Ejecuta f(0) ... f(num_tasks - 1) y bloquea hasta que terminen todas
+    void run(int num_tasks, std::function<void(int)> f) {
+        if (num_tasks <= 0) {
+            return;
+        }
+        if (size() == 0) {
+            for (int t = 0; t < num_tasks; ++t) {
+                f(t);
+            }
+            return;
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        // Ningún hilo puede seguir usando el job de la ronda anterior
+        work_done.wait(lock, [this] { return active == 0; });
+        job = std::move(f);
+        remaining.store(num_tasks);
+        metricsQueued(num_tasks);
+        for (int t = 0; t < num_tasks; ++t) {
+            WorkerQueue& q = queues[t % size()];
+            std::lock_guard<std::mutex> qlock(q.mutex);
+            q.tasks.push_back(t);
+        }
+        ++generation;
+        work_available.notify_all();
+        work_done.wait(lock, [this] { return remaining.load() == 0; });
+    }
+};
+
+#endif // WORK_STEALING_H
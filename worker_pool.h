@@ -0,0 +1,162 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "metrics.h"
+#include "task_arena.h"
+#include "trace.h"
+
+// Pool de hilos persistente: los hilos se crean una sola vez al inicio del
+// programa y se reutilizan en todas las llamadas, fuera de la región medida.
+// Además de la cola común, cada worker tiene una cola propia (submitTo) para
+// tareas que deben ejecutarse en un hilo concreto. Las colas son anillos que
+// no reservan memoria en régimen estacionario, y arena() guarda las tareas de
+// la llamada en curso.
+class WorkerPool {
+    std::vector<std::thread> workers;
+    TaskRing<std::function<void()>> queue;
+    std::vector<TaskRing<std::function<void()>>> own_queues;
+    TaskArena task_arena;
+    std::mutex mutex;
+    std::condition_variable work_available;
+    std::condition_variable work_done;
+    int pending = 0;
+    bool stopping = false;
+
+    void finishTask() {
+        long long before = traceNow(), waiting = metricsNow();
+        std::lock_guard<std::mutex> lock(mutex);
+        traceLockAcquired("pool lock", before);
+        metricsLockAcquired(waiting);
+        if (--pending == 0) {
+            work_done.notify_all();
+        }
+    }
+
+    void workerLoop(int id, std::function<void(int)> on_start) {
+        if (on_start) {
+            on_start(id);
+        }
+        TaskRing<std::function<void()>>& own = own_queues[id];
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                work_available.wait(lock, [this, &own] { return stopping || !own.empty() || !queue.empty(); });
+                TaskRing<std::function<void()>>& from = own.empty() ? queue : own;
+                if (from.empty()) {
+                    return; // stopping y sin trabajo pendiente
+                }
+                task = std::move(from.front());
+                from.pop_front();
+                metricsQueued(-1);
+            }
+
+            task();
+            finishTask();
+        }
+    }
+
+public:
+    // on_start(i) se ejecuta en el worker i antes de su primera tarea
+    explicit WorkerPool(int num_threads, std::function<void(int)> on_start = nullptr)
+        : own_queues(num_threads) {
+        workers.reserve(num_threads);
+        for (int i = 0; i < num_threads; ++i) {
+            workers.emplace_back(&WorkerPool::workerLoop, this, i, on_start);
+        }
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        work_available.notify_all();
+        for (auto& t : workers) {
+            t.join();
+        }
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    int size() const { return static_cast<int>(workers.size()); }
+
+    // Memoria para las tareas de una llamada; sólo la usa el hilo que reparte
+    TaskArena& arena() { return task_arena; }
+
+    void submit(std::function<void()> task) {
+        {
+            long long before = traceNow(), waiting = metricsNow();
+            std::lock_guard<std::mutex> lock(mutex);
+            traceLockAcquired("pool lock", before);
+            metricsLockAcquired(waiting);
+            queue.push_back(std::move(task));
+            ++pending;
+            metricsQueued(1);
+        }
+        work_available.notify_one();
+    }
+
+    // Encola la tarea para que la ejecute precisamente el worker indicado
+    void submitTo(int worker, std::function<void()> task) {
+        {
+            long long before = traceNow(), waiting = metricsNow();
+            std::lock_guard<std::mutex> lock(mutex);
+            traceLockAcquired("pool lock", before);
+            metricsLockAcquired(waiting);
+            own_queues[worker].push_back(std::move(task));
+            ++pending;
+            metricsQueued(1);
+        }
+        work_available.notify_all(); // hay que despertar a ese worker en concreto
+    }
+
+    // Ejecuta en el hilo llamante una tarea pendiente de la cola común, si la hay
+    bool runPendingTask() {
+        std::function<void()> task;
+        {
+            long long before = traceNow(), waiting = metricsNow();
+            std::lock_guard<std::mutex> lock(mutex);
+            traceLockAcquired("pool lock", before);
+            metricsLockAcquired(waiting);
+            if (queue.empty()) {
+                return false;
+            }
+            task = std::move(queue.front());
+            queue.pop_front();
+            metricsQueued(-1);
+        }
+        task();
+        finishTask();
+        return true;
+    }
+
+    // Espera a que done sea true ejecutando mientras tanto tareas pendientes,
+    // de modo que un fork/join anidado nunca bloquea un hilo del pool.
+    void helpUntil(const std::atomic<bool>& done) {
+        long long begin = traceNow();
+        while (!done.load(std::memory_order_acquire)) {
+            if (!runPendingTask()) {
+                std::this_thread::yield();
+            }
+        }
+        traceSpan("join", begin);
+    }
+
+    // Bloquea hasta que todas las tareas enviadas hayan terminado
+    void wait() {
+        long long begin = traceNow();
+        std::unique_lock<std::mutex> lock(mutex);
+        work_done.wait(lock, [this] { return pending == 0; });
+        traceSpan("wait", begin);
+    }
+};
+
+#endif // WORKER_POOL_H